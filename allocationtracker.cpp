@@ -0,0 +1,117 @@
+#include "allocationtracker.h"
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <iomanip>
+#include "demangle.h"
+
+using namespace std;
+
+AllocationTracker * AllocationTracker::current = nullptr;
+
+namespace
+{
+struct Unattributed final
+{
+};
+
+thread_local const type_info * currentSite = nullptr;
+thread_local bool recording = false; // the tracker's own map allocations go through operator new too
+}
+
+void * operator new(size_t size)
+{
+    AllocationTracker * tracker = AllocationTracker::current;
+    if(tracker != nullptr)
+        tracker->record(size);
+    void * retval = malloc(size == 0 ? 1 : size);
+    if(retval == nullptr)
+        throw bad_alloc();
+    return retval;
+}
+
+// gcc can't tell that the replacement operator new above is what allocated the block
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void * block) noexcept
+{
+    free(block);
+}
+
+void operator delete(void * block, size_t) noexcept
+{
+    free(block);
+}
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+const type_info * AllocationTracker::exchangeSite(const type_info * site)
+{
+    const type_info * retval = currentSite;
+    currentSite = site;
+    return retval;
+}
+
+AllocationTracker::AllocationTracker(bool detailed)
+    : detailed(detailed), allocationCount(0), byteCount(0)
+{
+}
+
+void AllocationTracker::record(size_t size)
+{
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    byteCount.fetch_add(size, memory_order_relaxed);
+    if(!detailed || recording)
+        return;
+    recording = true;
+    FrontEndStatistics::Phase phase = FrontEndStatistics::Phase::Other;
+    if(FrontEndStatistics::current != nullptr)
+        phase = FrontEndStatistics::current->getCurrentPhase();
+    type_index site(currentSite != nullptr ? *currentSite : typeid(Unattributed));
+    {
+        lock_guard<mutex> lockIt(detailLock);
+        Totals & totals = details[make_pair(phase, site)];
+        totals.allocations++;
+        totals.bytes += size;
+    }
+    recording = false;
+}
+
+void AllocationTracker::dump(wostream & os, size_t topCount)
+{
+    bool wasRecording = recording;
+    recording = true;
+    ios_base::fmtflags flags = os.flags();
+    vector<pair<pair<FrontEndStatistics::Phase, type_index>, Totals>> entries;
+    {
+        lock_guard<mutex> lockIt(detailLock);
+        entries.assign(details.begin(), details.end());
+    }
+    sort(entries.begin(), entries.end(), [](const pair<pair<FrontEndStatistics::Phase, type_index>, Totals> & a, const pair<pair<FrontEndStatistics::Phase, type_index>, Totals> & b)
+    {
+        if(get<1>(a).bytes != get<1>(b).bytes)
+            return get<1>(a).bytes > get<1>(b).bytes;
+        return get<1>(a).allocations > get<1>(b).allocations;
+    });
+    if(entries.size() > topCount)
+        entries.erase(entries.begin() + topCount, entries.end());
+    os << L"Allocations\n";
+    os << left << setw(24) << L"Total" << right << setw(14) << getAllocationCount() << setw(14) << getByteCount() << L" bytes\n";
+    os << L"Top Allocation Sites\n";
+    os << L"    " << left << setw(12) << L"Phase" << setw(32) << L"Site" << right << setw(14) << L"Allocations" << setw(14) << L"Bytes" << L"\n";
+    for(const pair<pair<FrontEndStatistics::Phase, type_index>, Totals> & entry : entries)
+    {
+        const type_index & site = get<1>(get<0>(entry));
+        wstring siteName = site == type_index(typeid(Unattributed)) ? wstring(L"(unattributed)") : demangleTypeName(site.name());
+        os << L"    " << left << setw(12) << FrontEndStatistics::getPhaseName(get<0>(get<0>(entry))) << setw(32) << siteName;
+        os << right << setw(14) << get<1>(entry).allocations << setw(14) << get<1>(entry).bytes << L"\n";
+    }
+    os.flush();
+    os.flags(flags);
+    recording = wasRecording;
+}
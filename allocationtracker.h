@@ -0,0 +1,74 @@
+#ifndef ALLOCATIONTRACKER_H_INCLUDED
+#define ALLOCATIONTRACKER_H_INCLUDED
+
+#include <cstddef>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <typeinfo>
+#include <typeindex>
+#include <utility>
+#include "frontendstatistics.h"
+
+using namespace std;
+
+/** counts heap allocations made through the global operator new; while current is nullptr every hook is a single null check
+ *
+ * allocations are attributed to the current front end phase and to the innermost Scope's site
+ */
+class AllocationTracker final
+{
+public:
+    struct Totals final
+    {
+        size_t allocations = 0;
+        size_t bytes = 0;
+    };
+    static AllocationTracker * current;
+    /** attributes allocations made while it is alive to T */
+    template <typename T>
+    class Scope final
+    {
+        const type_info * previousSite;
+    public:
+        Scope()
+            : previousSite(nullptr)
+        {
+            if(current != nullptr)
+                previousSite = exchangeSite(&typeid(T));
+        }
+        Scope(const Scope &) = delete;
+        const Scope & operator =(const Scope &) = delete;
+        ~Scope()
+        {
+            if(current != nullptr)
+                exchangeSite(previousSite);
+        }
+    };
+private:
+    const bool detailed;
+    atomic<size_t> allocationCount;
+    atomic<size_t> byteCount;
+    mutex detailLock;
+    map<pair<FrontEndStatistics::Phase, type_index>, Totals> details;
+    static const type_info * exchangeSite(const type_info * site);
+public:
+    /** when detailed is false only the totals are kept */
+    explicit AllocationTracker(bool detailed);
+    AllocationTracker(const AllocationTracker &) = delete;
+    const AllocationTracker & operator =(const AllocationTracker &) = delete;
+    void record(size_t size);
+    size_t getAllocationCount() const
+    {
+        return allocationCount.load(memory_order_relaxed);
+    }
+    size_t getByteCount() const
+    {
+        return byteCount.load(memory_order_relaxed);
+    }
+    /** writes the topCount sites that allocated the most bytes */
+    void dump(wostream & os, size_t topCount);
+};
+
+#endif // ALLOCATIONTRACKER_H_INCLUDED
@@ -12,27 +12,88 @@ protected:
     shared_ptr<ASTPeriod> name;
     shared_ptr<ASTPeriod> inherits;
     vector<shared_ptr<ASTPeriod>> implements;
+    size_t getHeaderChildCount() const
+    {
+        return (inherits != nullptr ? 2 : 1) + implements.size();
+    }
 public:
     ASTClass(LocationRange location, shared_ptr<ASTPeriod> name, shared_ptr<ASTPeriod> inherits, vector<shared_ptr<ASTPeriod>> implements, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables, vector<Token> modifiers, vector<shared_ptr<ASTNode>> nodes)
-        : ASTCodeBlock(location, imports, variables, nodes), modifiers(modifiers), name(name), inherits(inherits), implements(implements)
+        : ASTCodeBlock(ASTNodeKind::Class, location, imports, variables, nodes), modifiers(modifiers), name(name), inherits(inherits), implements(implements)
     {
     }
     ASTClass(LocationRange location, shared_ptr<ASTPeriod> name, shared_ptr<ASTPeriod> inherits, vector<shared_ptr<ASTPeriod>> implements, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables, vector<Token> modifiers, initializer_list<shared_ptr<ASTNode>> il)
-        : ASTCodeBlock(location, imports, variables, nodes), modifiers(modifiers), name(name), inherits(inherits), implements(implements)
+        : ASTCodeBlock(ASTNodeKind::Class, location, imports, variables, il), modifiers(modifiers), name(name), inherits(inherits), implements(implements)
     {
     }
     ASTClass(LocationRange location, shared_ptr<ASTPeriod> name, shared_ptr<ASTPeriod> inherits, vector<shared_ptr<ASTPeriod>> implements, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables, vector<Token> modifiers)
-        : ASTCodeBlock(location, imports, variables), modifiers(modifiers), name(name), inherits(inherits), implements(implements)
+        : ASTCodeBlock(ASTNodeKind::Class, location, imports, variables), modifiers(modifiers), name(name), inherits(inherits), implements(implements)
+    {
+    }
+    shared_ptr<ASTPeriod> getName() const
+    {
+        return name;
+    }
+    shared_ptr<ASTPeriod> getInherits() const
     {
+        return inherits;
+    }
+    const vector<shared_ptr<ASTPeriod>> & getImplements() const
+    {
+        return implements;
+    }
+    bool hasModifier(TokenType modifier) const
+    {
+        for(const Token & t : modifiers)
+        {
+            if(t.type == modifier)
+                return true;
+        }
+        return false;
     }
     virtual shared_ptr<ASTNode> dup() const override
     {
-        return make_shared<ASTClass>(location, name, inherits, implements, imports, variables, modifiers, nodes);
+        return makeASTNode<ASTClass>(location, name, inherits, implements, imports, variables, modifiers, nodes);
+    }
+    virtual shared_ptr<ASTNode> withNodes(vector<shared_ptr<ASTNode>> nodes) const override
+    {
+        return makeASTNode<ASTClass>(location, name, inherits, implements, imports, variables, modifiers, std::move(nodes));
+    }
+    virtual size_t getChildCount() const override
+    {
+        return getHeaderChildCount() + nodes.size();
+    }
+    virtual shared_ptr<ASTNode> getChild(size_t index) const override
+    {
+        if(index == 0)
+            return name;
+        if(inherits != nullptr && index == 1)
+            return inherits;
+        size_t implementsStart = inherits != nullptr ? 2 : 1;
+        if(index < implementsStart + implements.size())
+            return implements[index - implementsStart];
+        return nodes[index - getHeaderChildCount()];
+    }
+    virtual shared_ptr<ASTNode> withChild(size_t index, shared_ptr<ASTNode> child) const override
+    {
+        if(index >= getHeaderChildCount())
+            return ASTNode::withChild(index - getHeaderChildCount(), std::move(child));
+        if(child == nullptr || child->getKind() != ASTNodeKind::Period)
+            throw invalid_argument("ASTClass::withChild : name, inherits and implements must be periods");
+        shared_ptr<ASTPeriod> period = static_pointer_cast<ASTPeriod>(child);
+        shared_ptr<ASTPeriod> name = this->name, inherits = this->inherits;
+        vector<shared_ptr<ASTPeriod>> implements = this->implements;
+        if(index == 0)
+            name = period;
+        else if(inherits != nullptr && index == 1)
+            inherits = period;
+        else
+            implements[index - (inherits != nullptr ? 2 : 1)] = period;
+        return makeASTNode<ASTClass>(location, name, inherits, implements, imports, variables, modifiers, nodes);
     }
     virtual void dump(wostream & os, size_t indentLevel) const override
     {
         ASTNode::indent(os, indentLevel);
-        for(Token t : modifiers)
+        for(const Token & t : modifiers)
         {
             os << t.toSourceString() << L" ";
         }
@@ -54,14 +115,24 @@ public:
                 seperator = L", ";
             }
         }
-        os << endl;
+        os << L'\n';
         for(shared_ptr<ASTNode> node : nodes)
         {
             node->dump(os, indentLevel + 1);
-            os << endl;
+            os << L'\n';
         }
         ASTNode::indent(os, indentLevel);
-        os << getTokenAsPrintableString(TokenType::EndClass) << endl;
+        os << getTokenAsPrintableString(TokenType::EndClass) << L'\n';
+    }
+    virtual void exportTo(ASTExporter & exporter) const override
+    {
+        exporter.beginNode(getKind(), location);
+        exporter.tokenListAttribute(L"modifiers", modifiers);
+        exportChildren(exporter, L"name", vector<shared_ptr<ASTPeriod>>{name});
+        exportChildren(exporter, L"inherits", inherits != nullptr ? vector<shared_ptr<ASTPeriod>>{inherits} : vector<shared_ptr<ASTPeriod>>());
+        exportChildren(exporter, L"implements", implements);
+        exportChildren(exporter, L"nodes", nodes);
+        exporter.endNode();
     }
 };
 
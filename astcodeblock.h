@@ -2,6 +2,7 @@
 #define ASTCODEBLOCK_H_INCLUDED
 
 #include "astnode.h"
+#include "tokentype.h"
 #include <unordered_map>
 
 using namespace std;
@@ -14,16 +15,16 @@ protected:
     unordered_map<wstring, shared_ptr<ASTNode>> variables;
     vector<shared_ptr<ASTNamespace>> imports;
 public:
-    ASTCodeBlock(LocationRange location, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables, vector<shared_ptr<ASTNode>> nodes)
-        : ASTNode(location, nodes), variables(variables), imports(imports)
+    ASTCodeBlock(ASTNodeKind kind, LocationRange location, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables, vector<shared_ptr<ASTNode>> nodes)
+        : ASTNode(kind, location, nodes), variables(variables), imports(imports)
     {
     }
-    ASTCodeBlock(LocationRange location, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables, initializer_list<shared_ptr<ASTNode>> il)
-        : ASTNode(location, nodes), variables(variables), imports(imports)
+    ASTCodeBlock(ASTNodeKind kind, LocationRange location, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables, initializer_list<shared_ptr<ASTNode>> il)
+        : ASTNode(kind, location, il), variables(variables), imports(imports)
     {
     }
-    ASTCodeBlock(LocationRange location, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables)
-        : ASTNode(location), variables(variables), imports(imports)
+    ASTCodeBlock(ASTNodeKind kind, LocationRange location, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables)
+        : ASTNode(kind, location), variables(variables), imports(imports)
     {
     }
 };
@@ -32,32 +33,42 @@ class ASTBlock final : public ASTCodeBlock
 {
 public:
     ASTBlock(LocationRange location, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables, vector<shared_ptr<ASTNode>> nodes)
-        : ASTCodeBlock(location, imports, variables, nodes)
+        : ASTCodeBlock(ASTNodeKind::Block, location, imports, variables, nodes)
     {
     }
     ASTBlock(LocationRange location, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables, initializer_list<shared_ptr<ASTNode>> il)
-        : ASTCodeBlock(location, imports, variables, nodes)
+        : ASTCodeBlock(ASTNodeKind::Block, location, imports, variables, il)
     {
     }
     ASTBlock(LocationRange location, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables)
-        : ASTCodeBlock(location, imports, variables)
+        : ASTCodeBlock(ASTNodeKind::Block, location, imports, variables)
     {
     }
     virtual shared_ptr<ASTNode> dup() const override
     {
-        return make_shared<ASTBlock>(location, imports, variables, nodes);
+        return makeASTNode<ASTBlock>(location, imports, variables, nodes);
+    }
+    virtual shared_ptr<ASTNode> withNodes(vector<shared_ptr<ASTNode>> nodes) const override
+    {
+        return makeASTNode<ASTBlock>(location, imports, variables, std::move(nodes));
     }
     virtual void dump(wostream & os, size_t indentLevel) const override
     {
         ASTNode::indent(os, indentLevel);
-        os << getTokenAsPrintableString(TokenType::Block) << endl;
+        os << getTokenAsPrintableString(TokenType::Block) << L'\n';
         for(shared_ptr<ASTNode> node : nodes)
         {
             node->dump(os, indentLevel + 1);
-            os << endl;
+            os << L'\n';
         }
         ASTNode::indent(os, indentLevel);
-        os << getTokenAsPrintableString(TokenType::EndBlock) << endl;
+        os << getTokenAsPrintableString(TokenType::EndBlock) << L'\n';
+    }
+    virtual void exportTo(ASTExporter & exporter) const override
+    {
+        exporter.beginNode(getKind(), location);
+        exportChildren(exporter, L"nodes", nodes);
+        exporter.endNode();
     }
 };
 
@@ -65,29 +76,39 @@ class ASTGlobalBlock final : public ASTCodeBlock
 {
 public:
     ASTGlobalBlock(LocationRange location, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables, vector<shared_ptr<ASTNode>> nodes)
-        : ASTCodeBlock(location, imports, variables, nodes)
+        : ASTCodeBlock(ASTNodeKind::GlobalBlock, location, imports, variables, nodes)
     {
     }
     ASTGlobalBlock(LocationRange location, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables, initializer_list<shared_ptr<ASTNode>> il)
-        : ASTCodeBlock(location, imports, variables, nodes)
+        : ASTCodeBlock(ASTNodeKind::GlobalBlock, location, imports, variables, il)
     {
     }
     ASTGlobalBlock(LocationRange location, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables)
-        : ASTCodeBlock(location, imports, variables)
+        : ASTCodeBlock(ASTNodeKind::GlobalBlock, location, imports, variables)
     {
     }
     virtual shared_ptr<ASTNode> dup() const override
     {
-        return make_shared<ASTGlobalBlock>(location, imports, variables, nodes);
+        return makeASTNode<ASTGlobalBlock>(location, imports, variables, nodes);
+    }
+    virtual shared_ptr<ASTNode> withNodes(vector<shared_ptr<ASTNode>> nodes) const override
+    {
+        return makeASTNode<ASTGlobalBlock>(location, imports, variables, std::move(nodes));
     }
     virtual void dump(wostream & os, size_t indentLevel) const override
     {
         for(shared_ptr<ASTNode> node : nodes)
         {
             node->dump(os, indentLevel);
-            os << endl;
+            os << L'\n';
         }
     }
+    virtual void exportTo(ASTExporter & exporter) const override
+    {
+        exporter.beginNode(getKind(), location);
+        exportChildren(exporter, L"nodes", nodes);
+        exporter.endNode();
+    }
 };
 
 #endif // ASTCODEBLOCK_H_INCLUDED
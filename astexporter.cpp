@@ -0,0 +1,263 @@
+#include "astexporter.h"
+#include <cstdio>
+#include "json.h"
+#include "parser.h"
+
+using namespace std;
+
+namespace
+{
+constexpr size_t FlushSize = 1 << 16;
+}
+
+const char BinaryASTExporter::Magic[8] = {'O', 'O', 'P', 'A', 'S', 'T', '0', '1'};
+
+BinaryASTExporter::BinaryASTExporter(ostream & os)
+    : os(os)
+{
+    buffer.reserve(FlushSize + 64);
+    buffer.append(Magic, sizeof(Magic));
+}
+
+void BinaryASTExporter::writeVarInt(size_t value)
+{
+    while(value >= 0x80)
+    {
+        buffer += (char)(0x80 | (value & 0x7F));
+        value >>= 7;
+    }
+    buffer += (char)value;
+}
+
+void BinaryASTExporter::writeFixed64(uint64_t value)
+{
+    for(int i = 0; i < 8; i++)
+        buffer += (char)((value >> (8 * i)) & 0xFF);
+}
+
+void BinaryASTExporter::flushBuffer()
+{
+    os.write(buffer.data(), buffer.size());
+    fileOffset += buffer.size();
+    buffer.clear();
+}
+
+void BinaryASTExporter::beginNode(ASTNodeKind kind, const LocationRange & location)
+{
+    if(buffer.size() >= FlushSize)
+        flushBuffer();
+    buffer += (char)kind;
+    ptrdiff_t lineDelta = (ptrdiff_t)location.start.line - (ptrdiff_t)previousLine;
+    writeVarInt(lineDelta < 0 ? ((size_t)-lineDelta << 1) - 1 : (size_t)lineDelta << 1);
+    writeVarInt(location.start.column);
+    writeVarInt(location.end.line - location.start.line);
+    writeVarInt(location.end.column);
+    previousLine = location.start.line;
+}
+
+void BinaryASTExporter::nameAttribute(const wchar_t *, const wstring & value)
+{
+    auto iter = nameIndexes.find(value);
+    if(iter == nameIndexes.end())
+    {
+        iter = nameIndexes.insert(make_pair(value, names.size())).first;
+        names.push_back(JSONValue::toUTF8(value));
+    }
+    writeVarInt(get<1>(*iter));
+}
+
+void BinaryASTExporter::flagAttribute(const wchar_t *, bool value)
+{
+    buffer += (char)(value ? 1 : 0);
+}
+
+void BinaryASTExporter::tokenAttribute(const wchar_t *, TokenType value)
+{
+    writeVarInt((size_t)value);
+}
+
+void BinaryASTExporter::tokenListAttribute(const wchar_t *, const vector<Token> & value)
+{
+    writeVarInt(value.size());
+    for(const Token & token : value)
+        writeVarInt((size_t)token.type);
+}
+
+void BinaryASTExporter::beginChildren(const wchar_t *, size_t count)
+{
+    writeVarInt(count);
+}
+
+void BinaryASTExporter::finish()
+{
+    vector<uint64_t> nameOffsets;
+    nameOffsets.reserve(names.size());
+    for(const string & name : names)
+    {
+        if(buffer.size() >= FlushSize)
+            flushBuffer();
+        nameOffsets.push_back(fileOffset + buffer.size());
+        writeVarInt(name.size());
+        buffer += name;
+    }
+    while((fileOffset + buffer.size()) % 8 != 0)
+        buffer += '\0';
+    uint64_t nameOffsetsOffset = fileOffset + buffer.size();
+    for(uint64_t offset : nameOffsets)
+    {
+        if(buffer.size() >= FlushSize)
+            flushBuffer();
+        writeFixed64(offset);
+    }
+    writeFixed64(names.size());
+    writeFixed64(nameOffsetsOffset);
+    buffer.append(Magic, sizeof(Magic));
+    flushBuffer();
+    os.flush();
+}
+
+BinaryASTReader::BinaryASTReader(string data)
+    : data(std::move(data))
+{
+    constexpr size_t magicSize = sizeof(BinaryASTExporter::Magic);
+    constexpr size_t trailerSize = 16 + magicSize;
+    const string & d = this->data;
+    if(d.size() < magicSize + 1 + trailerSize || d.compare(0, magicSize, BinaryASTExporter::Magic, magicSize) != 0
+       || d.compare(d.size() - magicSize, magicSize, BinaryASTExporter::Magic, magicSize) != 0)
+        throw Exception(L"not a binary AST file");
+    nameCount = readFixed64(d.size() - trailerSize);
+    nameOffsetsOffset = readFixed64(d.size() - trailerSize + 8);
+    size_t nameOffsetsEnd = d.size() - trailerSize;
+    if(nameOffsetsOffset % 8 != 0 || nameOffsetsOffset <= magicSize || nameOffsetsOffset > nameOffsetsEnd
+       || nameCount != (nameOffsetsEnd - nameOffsetsOffset) / 8 || (nameOffsetsEnd - nameOffsetsOffset) % 8 != 0)
+        throw Exception(L"binary AST file has a corrupt trailer");
+}
+
+uint64_t BinaryASTReader::readFixed64(size_t offset) const
+{
+    uint64_t retval = 0;
+    for(int i = 0; i < 8; i++)
+        retval |= (uint64_t)(unsigned char)data[offset + i] << (8 * i);
+    return retval;
+}
+
+wstring BinaryASTReader::getName(size_t index) const
+{
+    if(index >= nameCount)
+        throw Exception(L"name index out of range");
+    uint64_t offset = readFixed64((size_t)nameOffsetsOffset + 8 * index);
+    size_t length = 0;
+    for(int shift = 0;; shift += 7)
+    {
+        if(offset >= nameOffsetsOffset || shift > 56)
+            throw Exception(L"binary AST file has a corrupt name");
+        unsigned char byte = data[(size_t)offset++];
+        length |= (size_t)(byte & 0x7F) << shift;
+        if((byte & 0x80) == 0)
+            break;
+    }
+    if(length > nameOffsetsOffset - offset)
+        throw Exception(L"binary AST file has a corrupt name");
+    return JSONValue::fromUTF8(data.substr((size_t)offset, length));
+}
+
+JSONASTExporter::JSONASTExporter(ostream & os)
+    : os(os)
+{
+    buffer.reserve(FlushSize + 256);
+}
+
+void JSONASTExporter::flushBuffer()
+{
+    os.write(buffer.data(), buffer.size());
+    buffer.clear();
+}
+
+void JSONASTExporter::writeSeparator()
+{
+    if(needsComma.empty())
+        return;
+    if(needsComma.back())
+        buffer += ',';
+    needsComma.back() = true;
+}
+
+void JSONASTExporter::writeKey(const wchar_t * key)
+{
+    writeSeparator();
+    buffer += '\"';
+    for(const wchar_t * p = key; *p != L'\0'; p++)
+        buffer += (char)*p; // keys are ASCII identifiers
+    buffer += "\":";
+}
+
+void JSONASTExporter::beginNode(ASTNodeKind kind, const LocationRange & location)
+{
+    if(buffer.size() >= FlushSize)
+        flushBuffer();
+    writeSeparator();
+    buffer += "{\"kind\":\"";
+    for(const wchar_t * p = getASTNodeKindName(kind); *p != L'\0'; p++)
+        buffer += (char)*p;
+    char text[96];
+    snprintf(text, sizeof(text), "\",\"location\":[%zu,%zu,%zu,%zu]", location.start.line, location.start.column, location.end.line, location.end.column);
+    buffer += text;
+    needsComma.push_back(true);
+}
+
+void JSONASTExporter::endNode()
+{
+    buffer += '}';
+    needsComma.pop_back();
+}
+
+void JSONASTExporter::nameAttribute(const wchar_t * key, const wstring & value)
+{
+    writeKey(key);
+    JSONValue::appendString(buffer, value);
+}
+
+void JSONASTExporter::flagAttribute(const wchar_t * key, bool value)
+{
+    writeKey(key);
+    buffer += value ? "true" : "false";
+}
+
+void JSONASTExporter::tokenAttribute(const wchar_t * key, TokenType value)
+{
+    writeKey(key);
+    JSONValue::appendString(buffer, getTokenAsPrintableString(value));
+}
+
+void JSONASTExporter::tokenListAttribute(const wchar_t * key, const vector<Token> & value)
+{
+    writeKey(key);
+    buffer += '[';
+    for(size_t i = 0; i < value.size(); i++)
+    {
+        if(i > 0)
+            buffer += ',';
+        JSONValue::appendString(buffer, value[i].toSourceString());
+    }
+    buffer += ']';
+}
+
+void JSONASTExporter::beginChildren(const wchar_t * key, size_t)
+{
+    writeKey(key);
+    buffer += '[';
+    needsComma.push_back(false);
+}
+
+void JSONASTExporter::endChildren()
+{
+    buffer += ']';
+    needsComma.pop_back();
+}
+
+void JSONASTExporter::finish()
+{
+    buffer += '\n';
+    flushBuffer();
+    os.flush();
+}
@@ -0,0 +1,134 @@
+#ifndef ASTEXPORTER_H_INCLUDED
+#define ASTEXPORTER_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <unordered_map>
+#include "location.h"
+#include "tokentype.h"
+#include "astnodekind.h"
+
+using namespace std;
+
+/** receives a depth-first walk of the tree from ASTNode::exportTo
+ *
+ * every node calls beginNode, then its attributes in a fixed order for its kind, then each child list, then endNode
+ */
+class ASTExporter
+{
+public:
+    virtual ~ASTExporter()
+    {
+    }
+    virtual void beginNode(ASTNodeKind kind, const LocationRange & location) = 0;
+    virtual void endNode() = 0;
+    virtual void nameAttribute(const wchar_t * key, const wstring & value) = 0;
+    virtual void flagAttribute(const wchar_t * key, bool value) = 0;
+    virtual void tokenAttribute(const wchar_t * key, TokenType value) = 0;
+    virtual void tokenListAttribute(const wchar_t * key, const vector<Token> & value) = 0;
+    virtual void beginChildren(const wchar_t * key, size_t count) = 0;
+    virtual void endChildren() = 0;
+};
+
+/** compact binary format; all fixed width integers are little endian
+ *
+ * file    : "OOPAST01", root node, name bytes, padding to 8 bytes, name offsets, trailer
+ * node    : kind byte, location, attributes in the order the node exports them, then each child list as a varint count followed by the nodes
+ * location: zigzag varint start line delta from the previous node's start line, varint start column, varint line count, varint end column
+ * name    : varint index into the name table
+ * flag    : one byte
+ * token   : varint TokenType
+ * tokens  : varint count followed by that many tokens
+ * name bytes   : per name, a varint byte length followed by the UTF-8 bytes
+ * name offsets : u64 file offset of each name's bytes, in name table order
+ * trailer : u64 name count, u64 offset of the name offsets, "OOPAST01"
+ *
+ * the trailer lets a reader that has mapped the file find any name without scanning the nodes; see BinaryASTReader
+ */
+class BinaryASTExporter final : public ASTExporter
+{
+    ostream & os;
+    string buffer;
+    size_t fileOffset = 0;
+    size_t previousLine = 0;
+    unordered_map<wstring, size_t> nameIndexes;
+    vector<string> names;
+    void writeVarInt(size_t value);
+    void writeFixed64(uint64_t value);
+    void flushBuffer();
+public:
+    static const char Magic[8];
+    explicit BinaryASTExporter(ostream & os);
+    BinaryASTExporter(const BinaryASTExporter &) = delete;
+    const BinaryASTExporter & operator =(const BinaryASTExporter &) = delete;
+    /** writes the name table and trailer; must be called once after the root node is exported */
+    void finish();
+    virtual void beginNode(ASTNodeKind kind, const LocationRange & location) override;
+    virtual void endNode() override
+    {
+    }
+    virtual void nameAttribute(const wchar_t * key, const wstring & value) override;
+    virtual void flagAttribute(const wchar_t * key, bool value) override;
+    virtual void tokenAttribute(const wchar_t * key, TokenType value) override;
+    virtual void tokenListAttribute(const wchar_t * key, const vector<Token> & value) override;
+    virtual void beginChildren(const wchar_t * key, size_t count) override;
+    virtual void endChildren() override
+    {
+    }
+};
+
+/** reads a BinaryASTExporter file's root kind and name table through the trailer, without decoding any nodes
+ *
+ * the constructor checks both magics and that the name offsets fit the layout; throws Exception if the file is malformed
+ */
+class BinaryASTReader final
+{
+    string data;
+    uint64_t nameCount;
+    uint64_t nameOffsetsOffset;
+    uint64_t readFixed64(size_t offset) const;
+public:
+    explicit BinaryASTReader(string data);
+    ASTNodeKind getRootKind() const
+    {
+        return (ASTNodeKind)(unsigned char)data[sizeof(BinaryASTExporter::Magic)];
+    }
+    size_t getNameCount() const
+    {
+        return (size_t)nameCount;
+    }
+    wstring getName(size_t index) const;
+};
+
+/** streams one JSON object per node; only a small output buffer and the current nesting are held in memory
+ *
+ * {"kind" : "Class", "location" : [startLine, startColumn, endLine, endColumn], attributes..., childList : [nodes...]}
+ */
+class JSONASTExporter final : public ASTExporter
+{
+    ostream & os;
+    string buffer;
+    vector<bool> needsComma; // one entry per open object or array
+    void writeSeparator();
+    void writeKey(const wchar_t * key);
+    void flushBuffer();
+public:
+    explicit JSONASTExporter(ostream & os);
+    JSONASTExporter(const JSONASTExporter &) = delete;
+    const JSONASTExporter & operator =(const JSONASTExporter &) = delete;
+    /** writes out anything still buffered; must be called once after the root node is exported */
+    void finish();
+    virtual void beginNode(ASTNodeKind kind, const LocationRange & location) override;
+    virtual void endNode() override;
+    virtual void nameAttribute(const wchar_t * key, const wstring & value) override;
+    virtual void flagAttribute(const wchar_t * key, bool value) override;
+    virtual void tokenAttribute(const wchar_t * key, TokenType value) override;
+    virtual void tokenListAttribute(const wchar_t * key, const vector<Token> & value) override;
+    virtual void beginChildren(const wchar_t * key, size_t count) override;
+    virtual void endChildren() override;
+};
+
+#endif // ASTEXPORTER_H_INCLUDED
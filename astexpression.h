@@ -10,16 +10,16 @@ private:
 protected:
     virtual shared_ptr<ASTType> calcType() = 0;
 public:
-    ASTExpression(LocationRange location, vector<shared_ptr<ASTNode>> nodes)
-        : ASTNode(location, nodes)
+    ASTExpression(ASTNodeKind kind, LocationRange location, vector<shared_ptr<ASTNode>> nodes)
+        : ASTNode(kind, location, nodes)
     {
     }
-    ASTExpression(LocationRange location, initializer_list<shared_ptr<ASTNode>> il)
-        : ASTNode(location, nodes)
+    ASTExpression(ASTNodeKind kind, LocationRange location, initializer_list<shared_ptr<ASTNode>> il)
+        : ASTNode(kind, location, il)
     {
     }
-    ASTExpression(LocationRange location)
-        : ASTNode(location)
+    ASTExpression(ASTNodeKind kind, LocationRange location)
+        : ASTNode(kind, location)
     {
     }
     shared_ptr<ASTType> getType()
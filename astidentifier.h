@@ -17,14 +17,14 @@ protected:
     }
 public:
     ASTIdentifier(LocationRange location, wstring value)
-        : ASTExpression(location), value(value)
+        : ASTExpression(ASTNodeKind::Identifier, location), value(std::move(value))
     {
     }
-    ASTIdentifier(Token t)
-        : ASTExpression(t.location), value(t.value)
+    ASTIdentifier(const Token & t)
+        : ASTExpression(ASTNodeKind::Identifier, t.location), value(t.value)
     {
     }
-    wstring getValue() const
+    const wstring & getValue() const
     {
         return value;
     }
@@ -34,7 +34,17 @@ public:
     }
     virtual shared_ptr<ASTNode> dup() const override
     {
-        return make_shared<ASTIdentifier>(location, value);
+        return makeASTNode<ASTIdentifier>(location, value);
+    }
+    virtual shared_ptr<ASTNode> withNodes(vector<shared_ptr<ASTNode>>) const override
+    {
+        return dup();
+    }
+    virtual void exportTo(ASTExporter & exporter) const override
+    {
+        exporter.beginNode(getKind(), location);
+        exporter.nameAttribute(L"value", value);
+        exporter.endNode();
     }
 };
 
@@ -48,7 +58,7 @@ protected:
     }
 public:
     ASTObjectIdentifier(LocationRange location)
-        : ASTExpression(location)
+        : ASTExpression(ASTNodeKind::ObjectIdentifier, location)
     {
     }
     wstring getValue() const
@@ -61,7 +71,16 @@ public:
     }
     virtual shared_ptr<ASTNode> dup() const override
     {
-        return make_shared<ASTObjectIdentifier>(location);
+        return makeASTNode<ASTObjectIdentifier>(location);
+    }
+    virtual shared_ptr<ASTNode> withNodes(vector<shared_ptr<ASTNode>>) const override
+    {
+        return dup();
+    }
+    virtual void exportTo(ASTExporter & exporter) const override
+    {
+        exporter.beginNode(getKind(), location);
+        exporter.endNode();
     }
 };
 
@@ -76,7 +95,7 @@ protected:
     }
 public:
     ASTSpecialIdentifier(LocationRange location, TokenType type)
-        : ASTExpression(location), type(type)
+        : ASTExpression(ASTNodeKind::SpecialIdentifier, location), type(type)
     {
     }
     wstring getValue() const
@@ -93,7 +112,17 @@ public:
     }
     virtual shared_ptr<ASTNode> dup() const override
     {
-        return make_shared<ASTSpecialIdentifier>(location, type);
+        return makeASTNode<ASTSpecialIdentifier>(location, type);
+    }
+    virtual shared_ptr<ASTNode> withNodes(vector<shared_ptr<ASTNode>>) const override
+    {
+        return dup();
+    }
+    virtual void exportTo(ASTExporter & exporter) const override
+    {
+        exporter.beginNode(getKind(), location);
+        exporter.tokenAttribute(L"value", type);
+        exporter.endNode();
     }
 };
 
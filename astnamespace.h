@@ -11,36 +11,52 @@ protected:
     wstring name;
 public:
     ASTNamespace(LocationRange location, wstring name, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables, vector<Token> modifiers, vector<shared_ptr<ASTNode>> nodes)
-        : ASTCodeBlock(location, imports, variables, nodes), modifiers(modifiers), name(name)
+        : ASTCodeBlock(ASTNodeKind::Namespace, location, imports, variables, nodes), modifiers(modifiers), name(std::move(name))
     {
     }
     ASTNamespace(LocationRange location, wstring name, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables, vector<Token> modifiers, initializer_list<shared_ptr<ASTNode>> il)
-        : ASTCodeBlock(location, imports, variables, nodes), modifiers(modifiers), name(name)
+        : ASTCodeBlock(ASTNodeKind::Namespace, location, imports, variables, il), modifiers(modifiers), name(std::move(name))
     {
     }
     ASTNamespace(LocationRange location, wstring name, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables, vector<Token> modifiers)
-        : ASTCodeBlock(location, imports, variables), modifiers(modifiers), name(name)
+        : ASTCodeBlock(ASTNodeKind::Namespace, location, imports, variables), modifiers(modifiers), name(std::move(name))
     {
     }
+    const wstring & getName() const
+    {
+        return name;
+    }
     virtual shared_ptr<ASTNode> dup() const override
     {
-        return make_shared<ASTNamespace>(location, name, imports, variables, modifiers, nodes);
+        return makeASTNode<ASTNamespace>(location, name, imports, variables, modifiers, nodes);
+    }
+    virtual shared_ptr<ASTNode> withNodes(vector<shared_ptr<ASTNode>> nodes) const override
+    {
+        return makeASTNode<ASTNamespace>(location, name, imports, variables, modifiers, std::move(nodes));
     }
     virtual void dump(wostream & os, size_t indentLevel) const override
     {
         ASTNode::indent(os, indentLevel);
-        for(Token t : modifiers)
+        for(const Token & t : modifiers)
         {
             os << t.toSourceString() << L" ";
         }
-        os << getTokenAsPrintableString(TokenType::Namespace) << L" " << name << endl;
+        os << getTokenAsPrintableString(TokenType::Namespace) << L" " << name << L'\n';
         for(shared_ptr<ASTNode> node : nodes)
         {
             node->dump(os, indentLevel + 1);
-            os << endl;
+            os << L'\n';
         }
         ASTNode::indent(os, indentLevel);
-        os << getTokenAsPrintableString(TokenType::EndNamespace) << endl;
+        os << getTokenAsPrintableString(TokenType::EndNamespace) << L'\n';
+    }
+    virtual void exportTo(ASTExporter & exporter) const override
+    {
+        exporter.beginNode(getKind(), location);
+        exporter.tokenListAttribute(L"modifiers", modifiers);
+        exporter.nameAttribute(L"name", name);
+        exportChildren(exporter, L"nodes", nodes);
+        exporter.endNode();
     }
 };
 
@@ -7,55 +7,108 @@
 #include <vector>
 #include <ostream>
 #include <initializer_list>
+#include <stdexcept>
 #include "location.h"
+#include "poolallocator.h"
+#include "frontendstatistics.h"
+#include "allocationtracker.h"
+#include "astexporter.h"
+#include "astnodekind.h"
 
 using namespace std;
 
+/** nodes are never modified after construction, so subtrees can be shared between trees
+ *
+ * parents aren't stored; use ASTPath to walk up from a node or to rebuild the path to the root after a change
+ */
 class ASTNode : public enable_shared_from_this<ASTNode>
 {
     friend class Parser;
+private:
+    ASTNodeKind kind;
 protected:
     LocationRange location;
-    weak_ptr<ASTNode> lexicalParent;
     vector<shared_ptr<ASTNode>> nodes;
-    shared_ptr<ASTNode> setLexicalParent(weak_ptr<ASTNode> lexicalParent)
+    template <typename T>
+    static void exportChildren(ASTExporter & exporter, const wchar_t * key, const vector<shared_ptr<T>> & children)
     {
-        this->lexicalParent = lexicalParent;
-        return shared_from_this();
+        exporter.beginChildren(key, children.size());
+        for(const shared_ptr<T> & child : children)
+            child->exportTo(exporter);
+        exporter.endChildren();
     }
 public:
-    ASTNode(LocationRange location, vector<shared_ptr<ASTNode>> nodes)
-        : location(location), nodes(nodes)
+    ASTNode(ASTNodeKind kind, LocationRange location, vector<shared_ptr<ASTNode>> nodes)
+        : kind(kind), location(location), nodes(nodes)
     {
     }
-    ASTNode(LocationRange location, initializer_list<shared_ptr<ASTNode>> il)
-        : location(location), nodes(il)
+    ASTNode(ASTNodeKind kind, LocationRange location, initializer_list<shared_ptr<ASTNode>> il)
+        : kind(kind), location(location), nodes(il)
     {
     }
-    ASTNode(LocationRange location)
-        : location(location)
+    ASTNode(ASTNodeKind kind, LocationRange location)
+        : kind(kind), location(location)
     {
     }
     virtual ~ASTNode()
     {
     }
+    ASTNodeKind getKind() const
+    {
+        return kind;
+    }
     LocationRange getLocation() const
     {
         return location;
     }
+    const vector<shared_ptr<ASTNode>> & getNodes() const
+    {
+        return nodes;
+    }
     virtual shared_ptr<ASTNode> dup() const = 0;
+    /** returns a node like this one but with nodes as its children; the children are shared, not copied */
+    virtual shared_ptr<ASTNode> withNodes(vector<shared_ptr<ASTNode>> nodes) const = 0;
+    /** children in walk order, the order ASTVisitor and the exporters use : nodes, after a class's or structure's name, inherits and implements */
+    virtual size_t getChildCount() const
+    {
+        return nodes.size();
+    }
+    virtual shared_ptr<ASTNode> getChild(size_t index) const
+    {
+        return nodes[index];
+    }
+    /** returns a node like this one with the child at index replaced; throws invalid_argument if child can't go there */
+    virtual shared_ptr<ASTNode> withChild(size_t index, shared_ptr<ASTNode> child) const
+    {
+        vector<shared_ptr<ASTNode>> nodes = this->nodes;
+        nodes[index] = std::move(child);
+        return withNodes(std::move(nodes));
+    }
     virtual void dump(wostream & os, size_t indentLevel) const = 0;
+    virtual void exportTo(ASTExporter & exporter) const = 0;
     void dump(wostream & os) const
     {
         return dump(os, 0);
     }
     static void indent(wostream & os, size_t indentLevel)
     {
-        for(size_t i = 0; i < indentLevel * TabWidth; i++)
+        static const wchar_t spaces[] = L"                                                                ";
+        constexpr size_t spaceCount = sizeof(spaces) / sizeof(spaces[0]) - 1;
+        for(size_t count = indentLevel * TabWidth; count > 0;)
         {
-            os << L" ";
+            size_t n = count < spaceCount ? count : spaceCount;
+            os.write(spaces, n);
+            count -= n;
         }
     }
 };
 
+template <typename T, typename ...Args>
+shared_ptr<T> makeASTNode(Args && ...args)
+{
+    FrontEndStatistics::countNode<T>();
+    AllocationTracker::Scope<T> allocationScope;
+    return allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
+
 #endif // ASTNODE_H_INCLUDED
@@ -0,0 +1,60 @@
+#ifndef ASTNODEKIND_H_INCLUDED
+#define ASTNODEKIND_H_INCLUDED
+
+#include <cstdint>
+
+using namespace std;
+
+/** one tag per concrete node class; stored in every ASTNode so passes can switch on it instead of using RTTI
+ *
+ * the values are also the kind tags of the binary export format, so only append new kinds
+ */
+enum class ASTNodeKind : uint8_t
+{
+    Identifier = 1,
+    ObjectIdentifier,
+    SpecialIdentifier,
+    Period,
+    Block,
+    GlobalBlock,
+    Namespace,
+    Class,
+    Structure,
+    TypeConst,
+    TypePointer,
+    TypeSpecial,
+};
+
+inline const wchar_t * getASTNodeKindName(ASTNodeKind kind)
+{
+    switch(kind)
+    {
+    case ASTNodeKind::Identifier:
+        return L"Identifier";
+    case ASTNodeKind::ObjectIdentifier:
+        return L"ObjectIdentifier";
+    case ASTNodeKind::SpecialIdentifier:
+        return L"SpecialIdentifier";
+    case ASTNodeKind::Period:
+        return L"Period";
+    case ASTNodeKind::Block:
+        return L"Block";
+    case ASTNodeKind::GlobalBlock:
+        return L"GlobalBlock";
+    case ASTNodeKind::Namespace:
+        return L"Namespace";
+    case ASTNodeKind::Class:
+        return L"Class";
+    case ASTNodeKind::Structure:
+        return L"Structure";
+    case ASTNodeKind::TypeConst:
+        return L"TypeConst";
+    case ASTNodeKind::TypePointer:
+        return L"TypePointer";
+    case ASTNodeKind::TypeSpecial:
+        return L"TypeSpecial";
+    }
+    return L"";
+}
+
+#endif // ASTNODEKIND_H_INCLUDED
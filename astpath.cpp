@@ -0,0 +1,79 @@
+#include "astpath.h"
+#include <stdexcept>
+
+using namespace std;
+
+shared_ptr<ASTNode> ASTPath::getParent() const
+{
+    if(steps.empty())
+        return nullptr;
+    const Step & step = steps.back();
+    if(!changed)
+        return step.parent;
+    return step.parent->withChild(step.index, node);
+}
+
+void ASTPath::down(size_t index)
+{
+    if(index >= node->getChildCount())
+        throw out_of_range("ASTPath::down : index out of range");
+    shared_ptr<ASTNode> child = node->getChild(index);
+    steps.push_back(Step(std::move(node), index, changed));
+    node = std::move(child);
+    changed = false;
+}
+
+void ASTPath::up()
+{
+    if(steps.empty())
+        return;
+    Step & step = steps.back();
+    if(changed)
+        node = step.parent->withChild(step.index, std::move(node));
+    else
+        node = std::move(step.parent);
+    changed = changed || step.parentChanged;
+    steps.pop_back();
+}
+
+bool ASTPath::next()
+{
+    if(steps.empty() || steps.back().index + 1 >= steps.back().parent->getChildCount())
+        return false;
+    size_t index = steps.back().index + 1;
+    up();
+    down(index);
+    return true;
+}
+
+shared_ptr<ASTNode> ASTPath::getRoot() const
+{
+    ASTPath path = *this;
+    while(!path.isRoot())
+        path.up();
+    return path.node;
+}
+
+bool ASTPath::findInternal(ASTPath & path, const ASTNode * target)
+{
+    if(path.node.get() == target)
+        return true;
+    size_t childCount = path.node->getChildCount();
+    for(size_t i = 0; i < childCount; i++)
+    {
+        path.down(i);
+        if(findInternal(path, target))
+            return true;
+        path.up();
+    }
+    return false;
+}
+
+bool ASTPath::find(shared_ptr<ASTNode> root, const ASTNode * target, ASTPath & path)
+{
+    ASTPath retval(std::move(root));
+    if(!findInternal(retval, target))
+        return false;
+    path = std::move(retval);
+    return true;
+}
@@ -0,0 +1,75 @@
+#ifndef ASTPATH_H_INCLUDED
+#define ASTPATH_H_INCLUDED
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "astnode.h"
+
+using namespace std;
+
+/** a zipper over ASTNode::getChild : the focused node plus the chain of ancestors leading to it from the root
+ *
+ * it sees the same children as ASTVisitor, including a class's name, inherits and implements;
+ * replace only changes the path; moving up rebuilds the parents of changed nodes with ASTNode::withChild,
+ * so a transformed tree shares every untouched subtree with the original
+ */
+class ASTPath final
+{
+    struct Step final
+    {
+        shared_ptr<ASTNode> parent;
+        size_t index;
+        bool parentChanged;
+        Step(shared_ptr<ASTNode> parent, size_t index, bool parentChanged)
+            : parent(std::move(parent)), index(index), parentChanged(parentChanged)
+        {
+        }
+    };
+    vector<Step> steps;
+    shared_ptr<ASTNode> node;
+    bool changed;
+    static bool findInternal(ASTPath & path, const ASTNode * target);
+public:
+    explicit ASTPath(shared_ptr<ASTNode> root)
+        : node(std::move(root)), changed(false)
+    {
+    }
+    const shared_ptr<ASTNode> & getNode() const
+    {
+        return node;
+    }
+    bool isRoot() const
+    {
+        return steps.empty();
+    }
+    size_t getDepth() const
+    {
+        return steps.size();
+    }
+    /** the focused node's position among its parent's children */
+    size_t getIndex() const
+    {
+        return steps.empty() ? 0 : steps.back().index;
+    }
+    /** returns nullptr at the root; the parent reflects any replacement under it */
+    shared_ptr<ASTNode> getParent() const;
+    /** moves the focus to the child at index; throws out_of_range if there is none */
+    void down(size_t index);
+    /** moves the focus to the parent; does nothing at the root */
+    void up();
+    /** moves the focus to the next sibling, returning false if there is none */
+    bool next();
+    /** a replaced name, inherits or implements must be an ASTPeriod or moving up throws invalid_argument */
+    void replace(shared_ptr<ASTNode> newNode)
+    {
+        node = std::move(newNode);
+        changed = true;
+    }
+    /** returns the root with every replacement applied; the original tree is left unchanged */
+    shared_ptr<ASTNode> getRoot() const;
+    /** computes the path from root to target on demand, returning false if target isn't in the tree */
+    static bool find(shared_ptr<ASTNode> root, const ASTNode * target, ASTPath & path);
+};
+
+#endif // ASTPATH_H_INCLUDED
@@ -1,4 +1,5 @@
 #include "astperiod.h"
+#include "astidentifier.h"
 #include <cassert>
 
 shared_ptr<ASTType> ASTPeriod::calcType()
@@ -6,3 +7,27 @@ shared_ptr<ASTType> ASTPeriod::calcType()
     assert(false);
 #warning finish ASTPeriod::calcType()
 }
+
+vector<wstring> ASTPeriod::getNames() const
+{
+    vector<wstring> retval;
+    retval.reserve(nodes.size());
+    for(const shared_ptr<ASTNode> & node : nodes)
+    {
+        switch(node->getKind())
+        {
+        case ASTNodeKind::Identifier:
+            retval.push_back(static_cast<const ASTIdentifier *>(node.get())->getValue());
+            break;
+        case ASTNodeKind::ObjectIdentifier:
+            retval.push_back(static_cast<const ASTObjectIdentifier *>(node.get())->getValue());
+            break;
+        case ASTNodeKind::SpecialIdentifier:
+            retval.push_back(static_cast<const ASTSpecialIdentifier *>(node.get())->getValue());
+            break;
+        default:
+            assert(false);
+        }
+    }
+    return retval;
+}
@@ -12,24 +12,29 @@ protected:
     virtual shared_ptr<ASTType> calcType() override;
 public:
     ASTPeriod(LocationRange location, bool startsWithPeriod, vector<shared_ptr<ASTNode>> nodes)
-        : ASTExpression(location, nodes), startsWithPeriod(startsWithPeriod)
+        : ASTExpression(ASTNodeKind::Period, location, nodes), startsWithPeriod(startsWithPeriod)
     {
     }
     ASTPeriod(LocationRange location, bool startsWithPeriod, initializer_list<shared_ptr<ASTNode>> il)
-        : ASTExpression(location, nodes), startsWithPeriod(startsWithPeriod)
+        : ASTExpression(ASTNodeKind::Period, location, il), startsWithPeriod(startsWithPeriod)
     {
     }
     ASTPeriod(LocationRange location, bool startsWithPeriod = false)
-        : ASTExpression(location), startsWithPeriod(startsWithPeriod)
+        : ASTExpression(ASTNodeKind::Period, location), startsWithPeriod(startsWithPeriod)
     {
     }
     bool doesStartWithPeriod() const
     {
         return startsWithPeriod;
     }
+    vector<wstring> getNames() const;
     virtual shared_ptr<ASTNode> dup() const override
     {
-        return make_shared<ASTPeriod>(location, startsWithPeriod, nodes);
+        return makeASTNode<ASTPeriod>(location, startsWithPeriod, nodes);
+    }
+    virtual shared_ptr<ASTNode> withNodes(vector<shared_ptr<ASTNode>> nodes) const override
+    {
+        return makeASTNode<ASTPeriod>(location, startsWithPeriod, std::move(nodes));
     }
     virtual void dump(wostream & os, size_t indentLevel) const override
     {
@@ -43,6 +48,13 @@ public:
             seperator = getTokenAsPrintableString(TokenType::Period);
         }
     }
+    virtual void exportTo(ASTExporter & exporter) const override
+    {
+        exporter.beginNode(getKind(), location);
+        exporter.flagAttribute(L"startsWithPeriod", startsWithPeriod);
+        exportChildren(exporter, L"nodes", nodes);
+        exporter.endNode();
+    }
 };
 
 #endif // ASTPERIOD_H_INCLUDED
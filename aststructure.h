@@ -0,0 +1,108 @@
+#ifndef ASTSTRUCTURE_H_INCLUDED
+#define ASTSTRUCTURE_H_INCLUDED
+
+#include "astcodeblock.h"
+#include "tokentype.h"
+#include "astperiod.h"
+
+class ASTStructure final : public ASTCodeBlock
+{
+protected:
+    vector<Token> modifiers;
+    shared_ptr<ASTPeriod> name;
+    vector<shared_ptr<ASTPeriod>> implements;
+public:
+    ASTStructure(LocationRange location, shared_ptr<ASTPeriod> name, vector<shared_ptr<ASTPeriod>> implements, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables, vector<Token> modifiers, vector<shared_ptr<ASTNode>> nodes)
+        : ASTCodeBlock(ASTNodeKind::Structure, location, imports, variables, nodes), modifiers(modifiers), name(name), implements(implements)
+    {
+    }
+    ASTStructure(LocationRange location, shared_ptr<ASTPeriod> name, vector<shared_ptr<ASTPeriod>> implements, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables, vector<Token> modifiers, initializer_list<shared_ptr<ASTNode>> il)
+        : ASTCodeBlock(ASTNodeKind::Structure, location, imports, variables, il), modifiers(modifiers), name(name), implements(implements)
+    {
+    }
+    ASTStructure(LocationRange location, shared_ptr<ASTPeriod> name, vector<shared_ptr<ASTPeriod>> implements, vector<shared_ptr<ASTNamespace>> imports, unordered_map<wstring, shared_ptr<ASTNode>> variables, vector<Token> modifiers)
+        : ASTCodeBlock(ASTNodeKind::Structure, location, imports, variables), modifiers(modifiers), name(name), implements(implements)
+    {
+    }
+    shared_ptr<ASTPeriod> getName() const
+    {
+        return name;
+    }
+    const vector<shared_ptr<ASTPeriod>> & getImplements() const
+    {
+        return implements;
+    }
+    virtual shared_ptr<ASTNode> dup() const override
+    {
+        return makeASTNode<ASTStructure>(location, name, implements, imports, variables, modifiers, nodes);
+    }
+    virtual shared_ptr<ASTNode> withNodes(vector<shared_ptr<ASTNode>> nodes) const override
+    {
+        return makeASTNode<ASTStructure>(location, name, implements, imports, variables, modifiers, std::move(nodes));
+    }
+    virtual size_t getChildCount() const override
+    {
+        return 1 + implements.size() + nodes.size();
+    }
+    virtual shared_ptr<ASTNode> getChild(size_t index) const override
+    {
+        if(index == 0)
+            return name;
+        if(index <= implements.size())
+            return implements[index - 1];
+        return nodes[index - 1 - implements.size()];
+    }
+    virtual shared_ptr<ASTNode> withChild(size_t index, shared_ptr<ASTNode> child) const override
+    {
+        if(index > implements.size())
+            return ASTNode::withChild(index - 1 - implements.size(), std::move(child));
+        if(child == nullptr || child->getKind() != ASTNodeKind::Period)
+            throw invalid_argument("ASTStructure::withChild : name and implements must be periods");
+        shared_ptr<ASTPeriod> period = static_pointer_cast<ASTPeriod>(child);
+        if(index == 0)
+            return makeASTNode<ASTStructure>(location, period, implements, imports, variables, modifiers, nodes);
+        vector<shared_ptr<ASTPeriod>> implements = this->implements;
+        implements[index - 1] = period;
+        return makeASTNode<ASTStructure>(location, name, implements, imports, variables, modifiers, nodes);
+    }
+    virtual void dump(wostream & os, size_t indentLevel) const override
+    {
+        ASTNode::indent(os, indentLevel);
+        for(const Token & t : modifiers)
+        {
+            os << t.toSourceString() << L" ";
+        }
+        os << getTokenAsPrintableString(TokenType::Structure) << L" ";
+        name->dump(os, indentLevel + 1);
+        if(implements.size() > 0)
+        {
+            os << L" " << getTokenAsPrintableString(TokenType::Implements);
+            wstring seperator = L" ";
+            for(shared_ptr<ASTPeriod> interface : implements)
+            {
+                os << seperator;
+                interface->dump(os, indentLevel + 1);
+                seperator = L", ";
+            }
+        }
+        os << L'\n';
+        for(shared_ptr<ASTNode> node : nodes)
+        {
+            node->dump(os, indentLevel + 1);
+            os << L'\n';
+        }
+        ASTNode::indent(os, indentLevel);
+        os << getTokenAsPrintableString(TokenType::EndStructure) << L'\n';
+    }
+    virtual void exportTo(ASTExporter & exporter) const override
+    {
+        exporter.beginNode(getKind(), location);
+        exporter.tokenListAttribute(L"modifiers", modifiers);
+        exportChildren(exporter, L"name", vector<shared_ptr<ASTPeriod>>{name});
+        exportChildren(exporter, L"implements", implements);
+        exportChildren(exporter, L"nodes", nodes);
+        exporter.endNode();
+    }
+};
+
+#endif // ASTSTRUCTURE_H_INCLUDED
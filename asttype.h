@@ -6,16 +6,16 @@
 class ASTType : public ASTNode
 {
 public:
-    ASTType(LocationRange location, vector<shared_ptr<ASTNode>> nodes)
-        : ASTNode(location, nodes)
+    ASTType(ASTNodeKind kind, LocationRange location, vector<shared_ptr<ASTNode>> nodes)
+        : ASTNode(kind, location, nodes)
     {
     }
-    ASTType(LocationRange location, initializer_list<shared_ptr<ASTNode>> il)
-        : ASTNode(location, nodes)
+    ASTType(ASTNodeKind kind, LocationRange location, initializer_list<shared_ptr<ASTNode>> il)
+        : ASTNode(kind, location, il)
     {
     }
-    ASTType(LocationRange location)
-        : ASTNode(location)
+    ASTType(ASTNodeKind kind, LocationRange location)
+        : ASTNode(kind, location)
     {
     }
 };
@@ -8,18 +8,28 @@ class ASTTypeConst final : public ASTType
 {
 public:
     ASTTypeConst(LocationRange location, shared_ptr<ASTNode> node)
-        : ASTType(location, {node})
+        : ASTType(ASTNodeKind::TypeConst, location, {node})
     {
     }
     virtual shared_ptr<ASTNode> dup() const override
     {
-        return make_shared<ASTTypeConst>(location, nodes[0]);
+        return makeASTNode<ASTTypeConst>(location, nodes[0]);
+    }
+    virtual shared_ptr<ASTNode> withNodes(vector<shared_ptr<ASTNode>> nodes) const override
+    {
+        return makeASTNode<ASTTypeConst>(location, nodes.at(0));
     }
     virtual void dump(wostream & os, size_t indentLevel) const override
     {
         os << getTokenAsPrintableString(TokenType::Const) << L" ";
         nodes[0]->dump(os, indentLevel);
     }
+    virtual void exportTo(ASTExporter & exporter) const override
+    {
+        exporter.beginNode(getKind(), location);
+        exportChildren(exporter, L"nodes", nodes);
+        exporter.endNode();
+    }
 };
 
 #endif // ASTTYPECONST_H_INCLUDED
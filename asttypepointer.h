@@ -8,18 +8,28 @@ class ASTTypePointer final : public ASTType
 {
 public:
     ASTTypePointer(LocationRange location, shared_ptr<ASTNode> node)
-        : ASTType(location, {node})
+        : ASTType(ASTNodeKind::TypePointer, location, {node})
     {
     }
     virtual shared_ptr<ASTNode> dup() const override
     {
-        return make_shared<ASTTypePointer>(location, nodes[0]);
+        return makeASTNode<ASTTypePointer>(location, nodes[0]);
+    }
+    virtual shared_ptr<ASTNode> withNodes(vector<shared_ptr<ASTNode>> nodes) const override
+    {
+        return makeASTNode<ASTTypePointer>(location, nodes.at(0));
     }
     virtual void dump(wostream & os, size_t indentLevel) const override
     {
         os << getTokenAsPrintableString(TokenType::Pointer) << L" " << getTokenAsPrintableString(TokenType::To) << L" ";
         nodes[0]->dump(os, indentLevel);
     }
+    virtual void exportTo(ASTExporter & exporter) const override
+    {
+        exporter.beginNode(getKind(), location);
+        exportChildren(exporter, L"nodes", nodes);
+        exporter.endNode();
+    }
 };
 
 #endif // ASTTYPEPOINTER_H_INCLUDED
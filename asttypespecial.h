@@ -10,7 +10,7 @@ private:
     TokenType type;
 public:
     ASTTypeSpecial(LocationRange location, TokenType type)
-        : ASTType(location), type(type)
+        : ASTType(ASTNodeKind::TypeSpecial, location), type(type)
     {
     }
     TokenType getType() const
@@ -19,12 +19,22 @@ public:
     }
     virtual shared_ptr<ASTNode> dup() const override
     {
-        return make_shared<ASTTypeSpecial>(location, type);
+        return makeASTNode<ASTTypeSpecial>(location, type);
+    }
+    virtual shared_ptr<ASTNode> withNodes(vector<shared_ptr<ASTNode>>) const override
+    {
+        return dup();
     }
     virtual void dump(wostream & os, size_t) const override
     {
         os << getTokenAsPrintableString(type);
     }
+    virtual void exportTo(ASTExporter & exporter) const override
+    {
+        exporter.beginNode(getKind(), location);
+        exporter.tokenAttribute(L"value", type);
+        exporter.endNode();
+    }
 };
 
 #endif // ASTTYPESPECIAL_H_INCLUDED
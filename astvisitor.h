@@ -0,0 +1,314 @@
+#ifndef ASTVISITOR_H_INCLUDED
+#define ASTVISITOR_H_INCLUDED
+
+#include <memory>
+#include <vector>
+#include "astnode.h"
+#include "astnodekind.h"
+#include "astidentifier.h"
+#include "astperiod.h"
+#include "astcodeblock.h"
+#include "astnamespace.h"
+#include "astclass.h"
+#include "aststructure.h"
+#include "asttypeconst.h"
+#include "asttypepointer.h"
+#include "asttypespecial.h"
+
+using namespace std;
+
+enum class ASTVisitResult
+{
+    Continue,
+    SkipChildren, // only meaningful from a pre hook
+    Stop,
+};
+
+/** statically dispatched depth-first walk : switches on ASTNode::getKind and calls Derived's hooks directly, so they can be inlined
+ *
+ * Derived declares public hooks named preKind / postKind (preClass, postPeriod, ...) for the kinds it cares about;
+ * the rest fall back to preNode / postNode, which continue by default.
+ * children are walked in ASTNode::getChild order : a class's name, inherits and implements come before its nodes
+ */
+template <typename Derived>
+class ASTVisitor
+{
+    Derived & derived()
+    {
+        return *static_cast<Derived *>(this);
+    }
+    template <typename T>
+    bool walkList(const vector<shared_ptr<T>> & children)
+    {
+        for(const shared_ptr<T> & child : children)
+        {
+            if(!walk(*child))
+                return false;
+        }
+        return true;
+    }
+    template <typename T>
+    bool walkChildren(const T & node)
+    {
+        return walkList(node.getNodes());
+    }
+    bool walkChildren(const ASTClass & node)
+    {
+        if(!walk(*node.getName()))
+            return false;
+        if(node.getInherits() != nullptr && !walk(*node.getInherits()))
+            return false;
+        return walkList(node.getImplements()) && walkList(node.getNodes());
+    }
+    bool walkChildren(const ASTStructure & node)
+    {
+        if(!walk(*node.getName()))
+            return false;
+        return walkList(node.getImplements()) && walkList(node.getNodes());
+    }
+    ASTVisitResult pre(const ASTIdentifier & node)
+    {
+        return derived().preIdentifier(node);
+    }
+    ASTVisitResult pre(const ASTObjectIdentifier & node)
+    {
+        return derived().preObjectIdentifier(node);
+    }
+    ASTVisitResult pre(const ASTSpecialIdentifier & node)
+    {
+        return derived().preSpecialIdentifier(node);
+    }
+    ASTVisitResult pre(const ASTPeriod & node)
+    {
+        return derived().prePeriod(node);
+    }
+    ASTVisitResult pre(const ASTBlock & node)
+    {
+        return derived().preBlock(node);
+    }
+    ASTVisitResult pre(const ASTGlobalBlock & node)
+    {
+        return derived().preGlobalBlock(node);
+    }
+    ASTVisitResult pre(const ASTNamespace & node)
+    {
+        return derived().preNamespace(node);
+    }
+    ASTVisitResult pre(const ASTClass & node)
+    {
+        return derived().preClass(node);
+    }
+    ASTVisitResult pre(const ASTStructure & node)
+    {
+        return derived().preStructure(node);
+    }
+    ASTVisitResult pre(const ASTTypeConst & node)
+    {
+        return derived().preTypeConst(node);
+    }
+    ASTVisitResult pre(const ASTTypePointer & node)
+    {
+        return derived().preTypePointer(node);
+    }
+    ASTVisitResult pre(const ASTTypeSpecial & node)
+    {
+        return derived().preTypeSpecial(node);
+    }
+    ASTVisitResult post(const ASTIdentifier & node)
+    {
+        return derived().postIdentifier(node);
+    }
+    ASTVisitResult post(const ASTObjectIdentifier & node)
+    {
+        return derived().postObjectIdentifier(node);
+    }
+    ASTVisitResult post(const ASTSpecialIdentifier & node)
+    {
+        return derived().postSpecialIdentifier(node);
+    }
+    ASTVisitResult post(const ASTPeriod & node)
+    {
+        return derived().postPeriod(node);
+    }
+    ASTVisitResult post(const ASTBlock & node)
+    {
+        return derived().postBlock(node);
+    }
+    ASTVisitResult post(const ASTGlobalBlock & node)
+    {
+        return derived().postGlobalBlock(node);
+    }
+    ASTVisitResult post(const ASTNamespace & node)
+    {
+        return derived().postNamespace(node);
+    }
+    ASTVisitResult post(const ASTClass & node)
+    {
+        return derived().postClass(node);
+    }
+    ASTVisitResult post(const ASTStructure & node)
+    {
+        return derived().postStructure(node);
+    }
+    ASTVisitResult post(const ASTTypeConst & node)
+    {
+        return derived().postTypeConst(node);
+    }
+    ASTVisitResult post(const ASTTypePointer & node)
+    {
+        return derived().postTypePointer(node);
+    }
+    ASTVisitResult post(const ASTTypeSpecial & node)
+    {
+        return derived().postTypeSpecial(node);
+    }
+    template <typename T>
+    bool walkNode(const T & node)
+    {
+        ASTVisitResult result = pre(node);
+        if(result == ASTVisitResult::Stop)
+            return false;
+        if(result == ASTVisitResult::Continue && !walkChildren(node))
+            return false;
+        return post(node) != ASTVisitResult::Stop;
+    }
+public:
+    ASTVisitResult preNode(const ASTNode &)
+    {
+        return ASTVisitResult::Continue;
+    }
+    ASTVisitResult postNode(const ASTNode &)
+    {
+        return ASTVisitResult::Continue;
+    }
+    ASTVisitResult preIdentifier(const ASTIdentifier & node)
+    {
+        return derived().preNode(node);
+    }
+    ASTVisitResult postIdentifier(const ASTIdentifier & node)
+    {
+        return derived().postNode(node);
+    }
+    ASTVisitResult preObjectIdentifier(const ASTObjectIdentifier & node)
+    {
+        return derived().preNode(node);
+    }
+    ASTVisitResult postObjectIdentifier(const ASTObjectIdentifier & node)
+    {
+        return derived().postNode(node);
+    }
+    ASTVisitResult preSpecialIdentifier(const ASTSpecialIdentifier & node)
+    {
+        return derived().preNode(node);
+    }
+    ASTVisitResult postSpecialIdentifier(const ASTSpecialIdentifier & node)
+    {
+        return derived().postNode(node);
+    }
+    ASTVisitResult prePeriod(const ASTPeriod & node)
+    {
+        return derived().preNode(node);
+    }
+    ASTVisitResult postPeriod(const ASTPeriod & node)
+    {
+        return derived().postNode(node);
+    }
+    ASTVisitResult preBlock(const ASTBlock & node)
+    {
+        return derived().preNode(node);
+    }
+    ASTVisitResult postBlock(const ASTBlock & node)
+    {
+        return derived().postNode(node);
+    }
+    ASTVisitResult preGlobalBlock(const ASTGlobalBlock & node)
+    {
+        return derived().preNode(node);
+    }
+    ASTVisitResult postGlobalBlock(const ASTGlobalBlock & node)
+    {
+        return derived().postNode(node);
+    }
+    ASTVisitResult preNamespace(const ASTNamespace & node)
+    {
+        return derived().preNode(node);
+    }
+    ASTVisitResult postNamespace(const ASTNamespace & node)
+    {
+        return derived().postNode(node);
+    }
+    ASTVisitResult preClass(const ASTClass & node)
+    {
+        return derived().preNode(node);
+    }
+    ASTVisitResult postClass(const ASTClass & node)
+    {
+        return derived().postNode(node);
+    }
+    ASTVisitResult preStructure(const ASTStructure & node)
+    {
+        return derived().preNode(node);
+    }
+    ASTVisitResult postStructure(const ASTStructure & node)
+    {
+        return derived().postNode(node);
+    }
+    ASTVisitResult preTypeConst(const ASTTypeConst & node)
+    {
+        return derived().preNode(node);
+    }
+    ASTVisitResult postTypeConst(const ASTTypeConst & node)
+    {
+        return derived().postNode(node);
+    }
+    ASTVisitResult preTypePointer(const ASTTypePointer & node)
+    {
+        return derived().preNode(node);
+    }
+    ASTVisitResult postTypePointer(const ASTTypePointer & node)
+    {
+        return derived().postNode(node);
+    }
+    ASTVisitResult preTypeSpecial(const ASTTypeSpecial & node)
+    {
+        return derived().preNode(node);
+    }
+    ASTVisitResult postTypeSpecial(const ASTTypeSpecial & node)
+    {
+        return derived().postNode(node);
+    }
+    /** returns false if a hook returned Stop */
+    bool walk(const ASTNode & node)
+    {
+        switch(node.getKind())
+        {
+        case ASTNodeKind::Identifier:
+            return walkNode(static_cast<const ASTIdentifier &>(node));
+        case ASTNodeKind::ObjectIdentifier:
+            return walkNode(static_cast<const ASTObjectIdentifier &>(node));
+        case ASTNodeKind::SpecialIdentifier:
+            return walkNode(static_cast<const ASTSpecialIdentifier &>(node));
+        case ASTNodeKind::Period:
+            return walkNode(static_cast<const ASTPeriod &>(node));
+        case ASTNodeKind::Block:
+            return walkNode(static_cast<const ASTBlock &>(node));
+        case ASTNodeKind::GlobalBlock:
+            return walkNode(static_cast<const ASTGlobalBlock &>(node));
+        case ASTNodeKind::Namespace:
+            return walkNode(static_cast<const ASTNamespace &>(node));
+        case ASTNodeKind::Class:
+            return walkNode(static_cast<const ASTClass &>(node));
+        case ASTNodeKind::Structure:
+            return walkNode(static_cast<const ASTStructure &>(node));
+        case ASTNodeKind::TypeConst:
+            return walkNode(static_cast<const ASTTypeConst &>(node));
+        case ASTNodeKind::TypePointer:
+            return walkNode(static_cast<const ASTTypePointer &>(node));
+        case ASTNodeKind::TypeSpecial:
+            return walkNode(static_cast<const ASTTypeSpecial &>(node));
+        }
+        return true;
+    }
+};
+
+#endif // ASTVISITOR_H_INCLUDED
@@ -0,0 +1,429 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+#include <cstdlib>
+#include "parser.h"
+#include "programgenerator.h"
+#include "json.h"
+#include "allocationtracker.h"
+#include "utf8outputbuffer.h"
+
+using namespace std;
+
+static constexpr int ResultsFormatVersion = 1;
+
+class Benchmark final
+{
+public:
+    struct Result
+    {
+        string scenario;
+        size_t targetSize = 0;
+        size_t inputBytes = 0;
+        size_t items = 0; // tokens, nodes or characters depending on the scenario
+        vector<double> seconds;
+        vector<size_t> allocations;
+        double getMedian() const
+        {
+            vector<double> sorted = seconds;
+            sort(sorted.begin(), sorted.end());
+            if(sorted.empty())
+                return 0;
+            if(sorted.size() % 2 == 0)
+                return (sorted[sorted.size() / 2 - 1] + sorted[sorted.size() / 2]) / 2;
+            return sorted[sorted.size() / 2];
+        }
+        double getP95() const
+        {
+            vector<double> sorted = seconds;
+            sort(sorted.begin(), sorted.end());
+            if(sorted.empty())
+                return 0;
+            size_t rank = (sorted.size() * 95 + 99) / 100; // nearest rank
+            return sorted[max<size_t>(rank, 1) - 1];
+        }
+        size_t getAllocationsPerRun() const
+        {
+            if(allocations.empty())
+                return 0;
+            return *min_element(allocations.begin(), allocations.end());
+        }
+        JSONValue toJSON() const
+        {
+            JSONValue retval = JSONValue::makeObject();
+            retval.set(L"scenario", scenario);
+            retval.set(L"targetSize", targetSize);
+            retval.set(L"inputBytes", inputBytes);
+            retval.set(L"items", items);
+            retval.set(L"iterations", seconds.size());
+            retval.set(L"medianSeconds", getMedian());
+            retval.set(L"p95Seconds", getP95());
+            retval.set(L"allocationsPerRun", getAllocationsPerRun());
+            return retval;
+        }
+    };
+private:
+    static int getNullOutput()
+    {
+#ifdef _WIN32
+        static FILE * nullOutput = fopen("NUL", "wb");
+#else
+        static FILE * nullOutput = fopen("/dev/null", "wb");
+#endif
+        if(nullOutput == nullptr)
+            throw Exception(L"can't open the null device");
+        return fileno(nullOutput);
+    }
+    static shared_ptr<ParserInput> openInput(const string & fileName)
+    {
+        return make_shared<IStreamParserInput>(make_shared<wifstream>(fileName));
+    }
+public:
+    static size_t tokenize(const string & fileName)
+    {
+        Parser::Tokenizer tokenizer(openInput(fileName));
+        size_t retval = 0;
+        while(tokenizer.nextTokenType() != TokenType::Eof)
+            retval++;
+        return retval;
+    }
+    static size_t countNodes(const ASTNode & node)
+    {
+        size_t retval = 1;
+        for(size_t i = 0; i < node.getChildCount(); i++)
+            retval += countNodes(*node.getChild(i));
+        return retval;
+    }
+    static shared_ptr<ASTNode> parse(const string & fileName)
+    {
+        Parser parser(openInput(fileName));
+        return parser.run();
+    }
+    static size_t dump(shared_ptr<ASTNode> ast)
+    {
+        UTF8OutputBuffer buffer(getNullOutput());
+        wostream os(&buffer);
+        ast->dump(os);
+        os.flush();
+        return buffer.getByteCount();
+    }
+    /** times fn; prepare runs before the clock starts and countItems, when given, after it stops */
+    static Result measure(string scenario, size_t targetSize, size_t inputBytes, size_t iterations, function<size_t()> fn, function<void()> prepare = nullptr, function<size_t()> countItems = nullptr)
+    {
+        Result retval;
+        retval.scenario = scenario;
+        retval.targetSize = targetSize;
+        retval.inputBytes = inputBytes;
+        AllocationTracker allocationTracker(false);
+        AllocationTracker::current = &allocationTracker;
+        for(size_t i = 0; i < iterations; i++)
+        {
+            if(prepare)
+                prepare();
+            size_t startAllocationCount = allocationTracker.getAllocationCount();
+            chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+            retval.items = fn();
+            retval.seconds.push_back(chrono::duration<double>(chrono::steady_clock::now() - startTime).count());
+            retval.allocations.push_back(allocationTracker.getAllocationCount() - startAllocationCount);
+            if(countItems)
+                retval.items = countItems();
+        }
+        AllocationTracker::current = nullptr;
+        return retval;
+    }
+};
+
+static bool parseSize(string text, size_t & size)
+{
+    size_t multiplier = 1;
+    if(!text.empty())
+    {
+        switch(text.back())
+        {
+        case 'k':
+        case 'K':
+            multiplier = (size_t)1 << 10;
+            break;
+        case 'm':
+        case 'M':
+            multiplier = (size_t)1 << 20;
+            break;
+        case 'g':
+        case 'G':
+            multiplier = (size_t)1 << 30;
+            break;
+        }
+        if(multiplier != 1)
+            text.erase(text.size() - 1);
+    }
+    if(text.empty() || text.find_first_not_of("0123456789") != string::npos)
+        return false;
+    size = stoull(text) * multiplier;
+    return true;
+}
+
+static size_t generateFile(const string & fileName, ProgramGenerator::Kind kind, size_t size)
+{
+    ProgramGenerator::Options options;
+    options.kind = kind;
+    options.targetSize = size;
+    ofstream os(fileName, ios::binary);
+    return ProgramGenerator(options).generate(os);
+}
+
+#define BENCHMARK_STRINGIFY2(x) #x
+#define BENCHMARK_STRINGIFY(x) BENCHMARK_STRINGIFY2(x)
+
+static JSONValue getBuildConfiguration()
+{
+    JSONValue retval = JSONValue::makeObject();
+#if defined(BUILD_TARGET)
+    retval.set(L"target", string(BENCHMARK_STRINGIFY(BUILD_TARGET)));
+#elif defined(__OPTIMIZE__)
+    retval.set(L"target", L"Release");
+#else
+    retval.set(L"target", L"Debug");
+#endif
+#if defined(__clang__)
+    retval.set(L"compiler", string("clang ") + __clang_version__);
+#elif defined(__GNUC__)
+    retval.set(L"compiler", string("gcc ") + __VERSION__);
+#else
+    retval.set(L"compiler", L"unknown");
+#endif
+#if defined(BUILD_FLAGS)
+    retval.set(L"flags", string(BENCHMARK_STRINGIFY(BUILD_FLAGS)));
+#else
+    retval.set(L"flags", L"unknown"); // only the Code::Blocks targets define BUILD_FLAGS
+#endif
+#if defined(__OPTIMIZE__)
+    retval.set(L"optimized", true);
+#else
+    retval.set(L"optimized", false);
+#endif
+#if defined(NDEBUG)
+    retval.set(L"assertions", false);
+#else
+    retval.set(L"assertions", true);
+#endif
+    retval.set(L"cplusplus", (size_t)__cplusplus);
+    return retval;
+}
+
+static void printResult(const Benchmark::Result & result)
+{
+    double median = result.getMedian();
+    wcout << left << setw(20) << wstring(result.scenario.begin(), result.scenario.end()) << right;
+    wcout << setw(14) << result.inputBytes << setw(12) << fixed << setprecision(6) << median << setw(12) << result.getP95();
+    wcout << setw(12) << setprecision(2) << (median > 0 ? result.inputBytes / median / (1 << 20) : 0.0);
+    wcout << setw(14) << result.items << setw(16) << setprecision(0) << (median > 0 ? result.items / median : 0.0);
+    wcout << setw(14) << result.getAllocationsPerRun() << endl;
+}
+
+static bool runBenchmarks(const vector<size_t> & sizes, size_t iterations, const string & directory, bool keepFiles, vector<Benchmark::Result> & results)
+{
+    wcout << left << setw(20) << L"Scenario" << right << setw(14) << L"Bytes" << setw(12) << L"Median s" << setw(12) << L"P95 s";
+    wcout << setw(12) << L"MiB/s" << setw(14) << L"Items" << setw(16) << L"Items/s" << setw(14) << L"Allocations" << endl;
+    for(size_t size : sizes)
+    {
+        string programFileName = directory + "/bench_program_" + to_string(size) + ".txt";
+        string soupFileName = directory + "/bench_soup_" + to_string(size) + ".txt";
+        size_t programBytes = generateFile(programFileName, ProgramGenerator::Kind::Program, size);
+        size_t soupBytes = generateFile(soupFileName, ProgramGenerator::Kind::TokenSoup, size);
+        results.push_back(Benchmark::measure("tokenize-program", size, programBytes, iterations, [&]()
+        {
+            return Benchmark::tokenize(programFileName);
+        }));
+        printResult(results.back());
+        results.push_back(Benchmark::measure("tokenize-soup", size, soupBytes, iterations, [&]()
+        {
+            return Benchmark::tokenize(soupFileName);
+        }));
+        printResult(results.back());
+        shared_ptr<ASTNode> ast;
+        results.push_back(Benchmark::measure("parse", size, programBytes, iterations, [&]()
+        {
+            ast = Benchmark::parse(programFileName);
+            return (size_t)0;
+        }, [&]()
+        {
+            ast = nullptr; // so freeing the previous tree isn't timed
+        }, [&]()
+        {
+            return ast != nullptr ? Benchmark::countNodes(*ast) : 0;
+        }));
+        printResult(results.back());
+        if(ast == nullptr)
+        {
+            wcerr << L"generated program failed to parse" << endl;
+            return false;
+        }
+        results.push_back(Benchmark::measure("dump", size, programBytes, iterations, [&]()
+        {
+            return Benchmark::dump(ast);
+        }));
+        printResult(results.back());
+        if(!keepFiles)
+        {
+            remove(programFileName.c_str());
+            remove(soupFileName.c_str());
+        }
+    }
+    return true;
+}
+
+static string readFile(const string & fileName)
+{
+    ifstream is(fileName, ios::binary);
+    if(!is)
+        throw Exception(L"can't open " + JSONValue::fromUTF8(fileName));
+    return string(istreambuf_iterator<char>(is), istreambuf_iterator<char>());
+}
+
+/** returns the number of regressed scenarios */
+static size_t compareWithBaseline(const vector<Benchmark::Result> & results, const JSONValue & baseline, double threshold)
+{
+    if(baseline[L"version"].getNumber() != ResultsFormatVersion)
+        throw Exception(L"unsupported baseline version");
+    wcout << L"\nComparison With Baseline (threshold " << fixed << setprecision(1) << threshold * 100 << L"%)\n";
+    wcout << left << setw(20) << L"Scenario" << right << setw(14) << L"Size" << setw(14) << L"Time Change" << setw(14) << L"Alloc Change" << endl;
+    size_t retval = 0;
+    for(const Benchmark::Result & result : results)
+    {
+        const JSONValue * baselineResult = nullptr;
+        for(const JSONValue & entry : baseline[L"results"].getArray())
+        {
+            if(entry[L"scenario"].getString() == JSONValue::fromUTF8(result.scenario) && (size_t)entry[L"targetSize"].getNumber() == result.targetSize)
+            {
+                baselineResult = &entry;
+                break;
+            }
+        }
+        wcout << left << setw(20) << JSONValue::fromUTF8(result.scenario) << right << setw(14) << result.targetSize;
+        if(baselineResult == nullptr)
+        {
+            wcout << setw(28) << L"no baseline" << endl;
+            continue;
+        }
+        double baselineMedian = (*baselineResult)[L"medianSeconds"].getNumber();
+        double baselineAllocations = (*baselineResult)[L"allocationsPerRun"].getNumber();
+        double timeChange = baselineMedian > 0 ? result.getMedian() / baselineMedian - 1 : 0;
+        double allocationChange = baselineAllocations > 0 ? result.getAllocationsPerRun() / baselineAllocations - 1 : (result.getAllocationsPerRun() > 0 ? 1 : 0);
+        wcout << showpos << setw(13) << timeChange * 100 << L"%" << setw(13) << allocationChange * 100 << L"%" << noshowpos;
+        if(timeChange > threshold || allocationChange > threshold)
+        {
+            wcout << L"  REGRESSION";
+            retval++;
+        }
+        wcout << endl;
+    }
+    return retval;
+}
+
+static void usage()
+{
+    wcerr << L"usage : oop-benchmark [--sizes=16K,1M,...] [--iterations=N] [--directory=DIR] [--keep-files]\n";
+    wcerr << L"                      [--json=FILE] [--baseline=FILE] [--threshold=PERCENT]\n";
+    wcerr << L"        oop-benchmark --generate=FILE [--size=N] [--kind=program|soup]" << endl;
+}
+int main(int argc, char ** argv)
+{
+    vector<size_t> sizes = {(size_t)16 << 10, (size_t)1 << 20, (size_t)16 << 20};
+    size_t iterations = 3;
+    size_t generateSize = (size_t)1 << 20;
+    string directory = ".";
+    string generateFileName;
+    ProgramGenerator::Kind kind = ProgramGenerator::Kind::Program;
+    bool keepFiles = false;
+    string jsonFileName;
+    string baselineFileName;
+    double threshold = 0.1;
+    for(int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if(arg.compare(0, 8, "--sizes=") == 0)
+        {
+            sizes.clear();
+            string list = arg.substr(8);
+            for(size_t start = 0; start <= list.size();)
+            {
+                size_t end = min(list.find(',', start), list.size());
+                size_t size;
+                if(!parseSize(list.substr(start, end - start), size))
+                {
+                    usage();
+                    return 1;
+                }
+                sizes.push_back(size);
+                start = end + 1;
+            }
+        }
+        else if(arg.compare(0, 13, "--iterations=") == 0 && parseSize(arg.substr(13), iterations) && iterations > 0)
+            continue;
+        else if(arg.compare(0, 12, "--directory=") == 0)
+            directory = arg.substr(12);
+        else if(arg == "--keep-files")
+            keepFiles = true;
+        else if(arg.compare(0, 11, "--generate=") == 0)
+            generateFileName = arg.substr(11);
+        else if(arg.compare(0, 7, "--size=") == 0 && parseSize(arg.substr(7), generateSize))
+            continue;
+        else if(arg.compare(0, 7, "--json=") == 0)
+            jsonFileName = arg.substr(7);
+        else if(arg.compare(0, 11, "--baseline=") == 0)
+            baselineFileName = arg.substr(11);
+        else if(arg.compare(0, 12, "--threshold=") == 0)
+            threshold = atof(arg.c_str() + 12) / 100;
+        else if(arg == "--kind=program")
+            kind = ProgramGenerator::Kind::Program;
+        else if(arg == "--kind=soup")
+            kind = ProgramGenerator::Kind::TokenSoup;
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+    if(!generateFileName.empty())
+    {
+        generateFile(generateFileName, kind, generateSize);
+        return 0;
+    }
+    try
+    {
+        vector<Benchmark::Result> results;
+        if(!runBenchmarks(sizes, iterations, directory, keepFiles, results))
+            return 1;
+        if(!jsonFileName.empty())
+        {
+            JSONValue output = JSONValue::makeObject();
+            output.set(L"version", ResultsFormatVersion);
+            output.set(L"build", getBuildConfiguration());
+            JSONValue & resultsJSON = output.set(L"results", JSONValue::makeArray());
+            for(const Benchmark::Result & result : results)
+                resultsJSON.push(result.toJSON());
+            ofstream os(jsonFileName, ios::binary);
+            os << output.toString(true) << "\n";
+            if(!os)
+                throw Exception(L"can't write " + JSONValue::fromUTF8(jsonFileName));
+        }
+        if(!baselineFileName.empty())
+        {
+            JSONValue baseline = JSONValue::parse(readFile(baselineFileName));
+            if(compareWithBaseline(results, baseline, threshold) > 0)
+                return 2;
+        }
+    }
+    catch(Exception & e)
+    {
+        wcerr << L"\nError : " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,251 @@
+#include "classhierarchy.h"
+#include <algorithm>
+#include "parser.h"
+#include "astcodeblock.h"
+#include "astnamespace.h"
+#include "aststructure.h"
+#include "astvisitor.h"
+
+using namespace std;
+
+namespace
+{
+wstring joinNames(const vector<wstring> & names)
+{
+    wstring retval;
+    for(const wstring & name : names)
+    {
+        if(!retval.empty())
+            retval += getTokenAsPrintableString(TokenType::Period);
+        retval += name;
+    }
+    return retval;
+}
+}
+
+class ClassHierarchy::Collector final : public ASTVisitor<Collector>
+{
+    Declarations & declarations;
+    vector<wstring> scope;
+    vector<size_t> scopeSizes;
+    vector<size_t> enclosingClasses;
+    void enterScope(const vector<wstring> & names)
+    {
+        scopeSizes.push_back(scope.size());
+        scope.insert(scope.end(), names.begin(), names.end());
+    }
+    ASTVisitResult leaveScope()
+    {
+        scope.resize(scopeSizes.back());
+        scopeSizes.pop_back();
+        return ASTVisitResult::Continue;
+    }
+    void declare(const ASTCodeBlock & node, shared_ptr<ASTPeriod> name)
+    {
+        Declarations::DeclaredClass declaredClass;
+        declaredClass.node = static_pointer_cast<const ASTCodeBlock>(node.shared_from_this());
+        declaredClass.outerScope = scope;
+        declaredClass.enclosingClass = enclosingClasses.back();
+        enterScope(name->getNames());
+        declaredClass.fullName = joinNames(scope);
+        enclosingClasses.push_back(declarations.classes.size());
+        declarations.classes.push_back(std::move(declaredClass));
+    }
+    ASTVisitResult undeclare()
+    {
+        enclosingClasses.pop_back();
+        return leaveScope();
+    }
+public:
+    explicit Collector(Declarations & declarations)
+        : declarations(declarations), enclosingClasses{Declarations::NoEnclosingClass}
+    {
+    }
+    ASTVisitResult preNode(const ASTNode &)
+    {
+        return ASTVisitResult::SkipChildren; // classes can only be nested in code blocks
+    }
+    ASTVisitResult preGlobalBlock(const ASTGlobalBlock &)
+    {
+        return ASTVisitResult::Continue;
+    }
+    ASTVisitResult preBlock(const ASTBlock &)
+    {
+        return ASTVisitResult::Continue;
+    }
+    ASTVisitResult preNamespace(const ASTNamespace & node)
+    {
+        enterScope(vector<wstring>{node.getName()});
+        return ASTVisitResult::Continue;
+    }
+    ASTVisitResult postNamespace(const ASTNamespace &)
+    {
+        return leaveScope();
+    }
+    ASTVisitResult preStructure(const ASTStructure & node)
+    {
+        declare(node, node.getName());
+        return ASTVisitResult::Continue;
+    }
+    ASTVisitResult postStructure(const ASTStructure &)
+    {
+        return undeclare();
+    }
+    ASTVisitResult preClass(const ASTClass & node)
+    {
+        declare(node, node.getName());
+        return ASTVisitResult::Continue;
+    }
+    ASTVisitResult postClass(const ASTClass &)
+    {
+        return undeclare();
+    }
+};
+
+shared_ptr<const ClassHierarchy::Declarations> ClassHierarchy::collect(const ASTNode & globalBlock)
+{
+    shared_ptr<Declarations> retval = make_shared<Declarations>();
+    Collector(*retval).walk(globalBlock);
+    return retval;
+}
+
+vector<shared_ptr<const ClassHierarchy::Declarations>> ClassHierarchy::collect(const vector<shared_ptr<ASTNode>> & globalBlocks)
+{
+    vector<shared_ptr<const Declarations>> retval;
+    retval.reserve(globalBlocks.size());
+    for(const shared_ptr<ASTNode> & globalBlock : globalBlocks)
+        retval.push_back(collect(*globalBlock));
+    return retval;
+}
+
+ClassHierarchy::ClassHierarchy(shared_ptr<ASTNode> globalBlock)
+    : ClassHierarchy(vector<shared_ptr<ASTNode>>{globalBlock})
+{
+}
+
+ClassHierarchy::ClassHierarchy(const vector<shared_ptr<ASTNode>> & globalBlocks)
+    : ClassHierarchy(collect(globalBlocks))
+{
+}
+
+ClassHierarchy::ClassHierarchy(const vector<shared_ptr<const Declarations>> & declarations)
+{
+    vector<pair<ClassInfo *, const vector<wstring> *>> scopes;
+    for(size_t root = 0; root < declarations.size(); root++)
+    {
+        const vector<Declarations::DeclaredClass> & declaredClasses = declarations[root]->classes;
+        vector<bool> added(declaredClasses.size(), false);
+        for(size_t i = 0; i < declaredClasses.size(); i++)
+        {
+            const Declarations::DeclaredClass & declaredClass = declaredClasses[i];
+            if(declaredClass.enclosingClass != Declarations::NoEnclosingClass && !added[declaredClass.enclosingClass])
+                continue; // nested in a duplicate
+            bool isStructure = declaredClass.node->getKind() == ASTNodeKind::Structure;
+            if(classes.count(declaredClass.fullName) != 0)
+            {
+                errors.push_back(Error((isStructure ? L"duplicate structure : " : L"duplicate class : ") + declaredClass.fullName, declaredClass.node->getLocation(), root));
+                continue;
+            }
+            added[i] = true;
+            ClassInfo & classInfo = classes[declaredClass.fullName];
+            classInfo.node = declaredClass.node;
+            classInfo.fullName = declaredClass.fullName;
+            classInfo.isStructure = isStructure;
+            classInfo.notInheritable = isStructure || static_cast<const ASTClass &>(*declaredClass.node).hasModifier(TokenType::NotInheritable);
+            classInfo.root = root;
+            references[classInfo.getName().get()] = declaredClass.fullName;
+            scopes.push_back(make_pair(&classInfo, &declaredClass.outerScope));
+        }
+    }
+    for(pair<ClassInfo *, const vector<wstring> *> & scope : scopes)
+    {
+        ClassInfo & classInfo = *get<0>(scope);
+        shared_ptr<ASTPeriod> inherits = classInfo.getInherits();
+        if(inherits != nullptr)
+        {
+            wstring baseName = resolve(inherits, *get<1>(scope));
+            references[inherits.get()] = baseName;
+            auto iter = classes.find(baseName);
+            if(iter != classes.end())
+            {
+                ClassInfo & base = get<1>(*iter);
+                if(base.isStructure)
+                {
+                    errors.push_back(Error(L"can't inherit from " + getTokenAsPrintableString(TokenType::Structure) + L" " + base.fullName, inherits->getLocation(), classInfo.root));
+                }
+                else if(base.notInheritable)
+                {
+                    errors.push_back(Error(L"can't inherit from " + getTokenAsPrintableString(TokenType::NotInheritable) + L" class " + base.fullName, inherits->getLocation(), classInfo.root));
+                }
+                else if(isBaseOf(classInfo, base))
+                {
+                    errors.push_back(Error(L"circular inheritance : " + classInfo.fullName + L" can't inherit from " + base.fullName, inherits->getLocation(), classInfo.root));
+                }
+                else
+                {
+                    classInfo.base = &base;
+                    base.derived.push_back(&classInfo);
+                }
+            }
+        }
+        for(shared_ptr<ASTPeriod> interface : classInfo.getImplements())
+        {
+            classInfo.implements.push_back(resolve(interface, *get<1>(scope)));
+            references[interface.get()] = classInfo.implements.back();
+            implementers[classInfo.implements.back()].push_back(&classInfo);
+        }
+    }
+}
+
+wstring ClassHierarchy::resolve(shared_ptr<ASTPeriod> name, const vector<wstring> & scope) const
+{
+    vector<wstring> names = name->getNames();
+    if(names.size() == 1 && names[0] == getTokenAsPrintableString(TokenType::Object))
+        return names[0];
+    if(!names.empty() && names[0] == getTokenAsPrintableString(TokenType::Global))
+    {
+        names.erase(names.begin());
+        return joinNames(names);
+    }
+    wstring relativeName = joinNames(names);
+    for(size_t depth = scope.size() + 1; depth-- > 0;)
+    {
+        wstring retval = joinNames(vector<wstring>(scope.begin(), scope.begin() + depth));
+        if(!retval.empty())
+            retval += getTokenAsPrintableString(TokenType::Period);
+        retval += relativeName;
+        if(classes.count(retval) != 0)
+            return retval;
+    }
+    // declared outside the program : qualify it with the enclosing scope so every spelling of it from here gets one key
+    vector<wstring> fullNames = scope;
+    fullNames.insert(fullNames.end(), names.begin(), names.end());
+    return joinNames(fullNames);
+}
+
+void ClassHierarchy::dump(wostream & os) const
+{
+    vector<const ClassInfo *> sortedClasses;
+    sortedClasses.reserve(classes.size());
+    for(const pair<const wstring, ClassInfo> & classInfo : classes)
+        sortedClasses.push_back(&get<1>(classInfo));
+    sort(sortedClasses.begin(), sortedClasses.end(), [](const ClassInfo * a, const ClassInfo * b)
+    {
+        return a->fullName < b->fullName;
+    });
+    for(const ClassInfo * classInfo : sortedClasses)
+    {
+        if(classInfo->isStructure)
+        {
+            os << classInfo->fullName << L" : " << getTokenAsPrintableString(TokenType::Structure) << L"\n";
+            continue;
+        }
+        os << classInfo->fullName << L" : " << getTokenAsPrintableString(TokenType::Inherits) << L" ";
+        os << (classInfo->base != nullptr ? classInfo->base->fullName : getTokenAsPrintableString(TokenType::Object));
+        os << L", " << classInfo->derived.size() << L" derived";
+        if(isEffectivelyFinal(*classInfo))
+            os << L", final";
+        os << L"\n";
+    }
+    os.flush();
+}
@@ -0,0 +1,142 @@
+#ifndef CLASSHIERARCHY_H_INCLUDED
+#define CLASSHIERARCHY_H_INCLUDED
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <unordered_map>
+#include "astnode.h"
+#include "astclass.h"
+#include "aststructure.h"
+#include "parser.h"
+
+using namespace std;
+
+/** errors don't stop the build : a duplicate class is left out and a disallowed Inherits isn't linked, so the rest stays usable
+ *
+ * structures are entered too, so they can be found and can implement interfaces, but as value types they're never inheritable
+ */
+class ClassHierarchy final
+{
+public:
+    struct ClassInfo final
+    {
+        shared_ptr<const ASTCodeBlock> node; // an ASTClass, or an ASTStructure when isStructure
+        wstring fullName;
+        const ClassInfo * base = nullptr; // nullptr for classes inheriting Object and for structures
+        vector<const ClassInfo *> derived;
+        vector<wstring> implements;
+        bool notInheritable = false;
+        bool isStructure = false;
+        size_t root = 0; // index of the global block declaring it
+        shared_ptr<ASTPeriod> getName() const
+        {
+            if(isStructure)
+                return static_cast<const ASTStructure &>(*node).getName();
+            return static_cast<const ASTClass &>(*node).getName();
+        }
+        /** nullptr for structures */
+        shared_ptr<ASTPeriod> getInherits() const
+        {
+            if(isStructure)
+                return nullptr;
+            return static_cast<const ASTClass &>(*node).getInherits();
+        }
+        const vector<shared_ptr<ASTPeriod>> & getImplements() const
+        {
+            if(isStructure)
+                return static_cast<const ASTStructure &>(*node).getImplements();
+            return static_cast<const ASTClass &>(*node).getImplements();
+        }
+    };
+    /** the classes one global block declares; collected once per tree, so after an edit only the changed block is walked again */
+    struct Declarations final
+    {
+        static constexpr size_t NoEnclosingClass = (size_t)-1;
+        struct DeclaredClass final
+        {
+            shared_ptr<const ASTCodeBlock> node; // an ASTClass or an ASTStructure
+            wstring fullName;
+            vector<wstring> outerScope; // where its Inherits and Implements paths are resolved
+            size_t enclosingClass; // index of the class or structure it's nested in, or NoEnclosingClass
+        };
+        vector<DeclaredClass> classes;
+    };
+    /** a ParseError that also says which global block it's in */
+    struct Error final : public ParseError
+    {
+        const size_t root;
+        Error(wstring msg, LocationRange location, size_t root)
+            : ParseError(std::move(msg), location), root(root)
+        {
+        }
+    };
+private:
+    unordered_map<wstring, ClassInfo> classes;
+    unordered_map<wstring, vector<const ClassInfo *>> implementers;
+    unordered_map<const ASTPeriod *, wstring> references; // every class name, Inherits and Implements path, resolved
+    vector<Error> errors;
+    class Collector;
+    wstring resolve(shared_ptr<ASTPeriod> name, const vector<wstring> & scope) const;
+    static vector<shared_ptr<const Declarations>> collect(const vector<shared_ptr<ASTNode>> & globalBlocks);
+public:
+    explicit ClassHierarchy(shared_ptr<ASTNode> globalBlock);
+    /** one program split over several files; classes in any block can refer to classes in the others */
+    explicit ClassHierarchy(const vector<shared_ptr<ASTNode>> & globalBlocks);
+    /** links classes already collected from each global block; only resolves names, nothing is walked */
+    explicit ClassHierarchy(const vector<shared_ptr<const Declarations>> & declarations);
+    static shared_ptr<const Declarations> collect(const ASTNode & globalBlock);
+    const ClassInfo * find(const wstring & fullName) const
+    {
+        auto iter = classes.find(fullName);
+        if(iter == classes.end())
+            return nullptr;
+        return &get<1>(*iter);
+    }
+    const unordered_map<wstring, ClassInfo> & getClasses() const
+    {
+        return classes;
+    }
+    const vector<const ClassInfo *> & getImplementers(const wstring & interfaceName) const
+    {
+        static const vector<const ClassInfo *> none;
+        auto iter = implementers.find(interfaceName);
+        if(iter == implementers.end())
+            return none;
+        return get<1>(*iter);
+    }
+    /** returns the full name a class name, Inherits or Implements path resolved to, or an empty string for any other path;
+     * a relative name the program doesn't declare is qualified with the scope it's written in */
+    const wstring & getReferenceName(const ASTPeriod * path) const
+    {
+        static const wstring none;
+        auto iter = references.find(path);
+        if(iter == references.end())
+            return none;
+        return get<1>(*iter);
+    }
+    /** true if classInfo is derivedClassInfo or one of its bases */
+    static bool isBaseOf(const ClassInfo & classInfo, const ClassInfo & derivedClassInfo)
+    {
+        for(const ClassInfo * current = &derivedClassInfo; current != nullptr; current = current->base)
+        {
+            if(current == &classInfo)
+                return true;
+        }
+        return false;
+    }
+    /** a class is effectively final when no class in the whole program can derive from it,
+     * so every overridable member has exactly one implementation when called through it */
+    static bool isEffectivelyFinal(const ClassInfo & classInfo)
+    {
+        return classInfo.notInheritable || classInfo.derived.empty();
+    }
+    const vector<Error> & getErrors() const
+    {
+        return errors;
+    }
+    void dump(wostream & os) const;
+};
+
+#endif // CLASSHIERARCHY_H_INCLUDED
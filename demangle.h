@@ -0,0 +1,28 @@
+#ifndef DEMANGLE_H_INCLUDED
+#define DEMANGLE_H_INCLUDED
+
+#include <string>
+#include <cstdlib>
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+using namespace std;
+
+inline wstring demangleTypeName(const char * name)
+{
+    string retval = name;
+#ifdef __GNUG__
+    int status = 0;
+    char * demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if(demangled != nullptr)
+    {
+        if(status == 0)
+            retval = demangled;
+        free(demangled);
+    }
+#endif
+    return wstring(retval.begin(), retval.end());
+}
+
+#endif // DEMANGLE_H_INCLUDED
@@ -0,0 +1,149 @@
+#include "frontendstatistics.h"
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <iomanip>
+#include "demangle.h"
+#include "json.h"
+#ifdef __unix__
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+FrontEndStatistics * FrontEndStatistics::current = nullptr;
+
+namespace
+{
+vector<pair<wstring, size_t>> sortCounts(vector<pair<wstring, size_t>> counts)
+{
+    sort(counts.begin(), counts.end(), [](const pair<wstring, size_t> & a, const pair<wstring, size_t> & b)
+    {
+        if(get<1>(a) != get<1>(b))
+            return get<1>(a) > get<1>(b);
+        return get<0>(a) < get<0>(b);
+    });
+    return counts;
+}
+}
+
+FrontEndStatistics::FrontEndStatistics()
+    : startTime(chrono::steady_clock::now()), lastSwitchTime(startTime), currentPhase(Phase::Other)
+{
+}
+
+FrontEndStatistics::Phase FrontEndStatistics::switchPhase(Phase phase)
+{
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    phaseSeconds[(size_t)currentPhase] += chrono::duration<double>(now - lastSwitchTime).count();
+    lastSwitchTime = now;
+    Phase retval = currentPhase;
+    currentPhase = phase;
+    return retval;
+}
+
+const wchar_t * FrontEndStatistics::getPhaseName(Phase phase)
+{
+    switch(phase)
+    {
+    case Phase::Other:
+        return L"Other";
+    case Phase::InputRead:
+        return L"Input Read";
+    case Phase::Tokenize:
+        return L"Tokenize";
+    case Phase::Parse:
+        return L"Parse";
+    case Phase::Dump:
+        return L"Dump";
+    case Phase::Count:
+        break;
+    }
+    return L"";
+}
+
+size_t FrontEndStatistics::getPeakMemoryBytes()
+{
+#ifdef __unix__
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) == 0)
+        return (size_t)usage.ru_maxrss * 1024;
+#endif
+    return 0;
+}
+
+size_t FrontEndStatistics::getTokenCount() const
+{
+    size_t retval = 0;
+    for(size_t count : tokenCounts)
+        retval += count;
+    return retval;
+}
+
+void FrontEndStatistics::dump(wostream & os)
+{
+    switchPhase(currentPhase);
+    double totalSeconds = chrono::duration<double>(lastSwitchTime - startTime).count();
+    double frontEndSeconds = phaseSeconds[(size_t)Phase::InputRead] + phaseSeconds[(size_t)Phase::Tokenize] + phaseSeconds[(size_t)Phase::Parse];
+    ios_base::fmtflags flags = os.flags();
+    streamsize precision = os.precision();
+    os << fixed << setprecision(6);
+    os << L"Front End Statistics\n";
+    for(size_t phase = 0; phase < (size_t)Phase::Count; phase++)
+        os << left << setw(24) << getPhaseName((Phase)phase) << right << setw(14) << phaseSeconds[phase] << L" s\n";
+    os << left << setw(24) << L"Total" << right << setw(14) << totalSeconds << L" s\n";
+    os << setprecision(1);
+    os << left << setw(24) << L"Bytes" << right << setw(14) << byteCount << L"\n";
+    os << left << setw(24) << L"Characters" << right << setw(14) << characterCount << L"\n";
+    os << left << setw(24) << L"Tokens" << right << setw(14) << getTokenCount() << L"\n";
+    if(frontEndSeconds > 0)
+    {
+        os << left << setw(24) << L"Bytes/s" << right << setw(14) << byteCount / frontEndSeconds << L"\n";
+        os << left << setw(24) << L"Tokens/s" << right << setw(14) << getTokenCount() / frontEndSeconds << L"\n";
+    }
+    os << left << setw(24) << L"Peak Memory" << right << setw(14) << getPeakMemoryBytes() / 1024 << L" KiB\n";
+    vector<pair<wstring, size_t>> counts;
+    for(size_t token = 0; token < TokenTypeCount; token++)
+    {
+        if(tokenCounts[token] != 0)
+            counts.push_back(make_pair(getTokenAsPrintableString((TokenType)token), tokenCounts[token]));
+    }
+    os << L"Tokens By Type\n";
+    for(const pair<wstring, size_t> & count : sortCounts(counts))
+        os << L"    " << left << setw(20) << get<0>(count) << right << setw(14) << get<1>(count) << L"\n";
+    counts.clear();
+    for(const pair<const type_index, size_t> & count : nodeCounts)
+        counts.push_back(make_pair(demangleTypeName(get<0>(count).name()), get<1>(count)));
+    os << L"Nodes By Class\n";
+    for(const pair<wstring, size_t> & count : sortCounts(counts))
+        os << L"    " << left << setw(20) << get<0>(count) << right << setw(14) << get<1>(count) << L"\n";
+    os.flush();
+    os.flags(flags);
+    os.precision(precision);
+}
+
+void FrontEndStatistics::dumpJSON(ostream & os)
+{
+    switchPhase(currentPhase);
+    double totalSeconds = chrono::duration<double>(lastSwitchTime - startTime).count();
+    JSONValue retval = JSONValue::makeObject();
+    JSONValue & phases = retval.set(L"phases", JSONValue::makeObject());
+    for(size_t phase = 0; phase < (size_t)Phase::Count; phase++)
+        phases.set(getPhaseName((Phase)phase), phaseSeconds[phase]);
+    retval.set(L"totalSeconds", totalSeconds);
+    retval.set(L"bytes", byteCount);
+    retval.set(L"characters", characterCount);
+    retval.set(L"tokens", getTokenCount());
+    retval.set(L"peakMemoryBytes", getPeakMemoryBytes());
+    JSONValue & tokensByType = retval.set(L"tokensByType", JSONValue::makeObject());
+    for(size_t token = 0; token < TokenTypeCount; token++)
+    {
+        if(tokenCounts[token] != 0)
+            tokensByType.set(getTokenAsPrintableString((TokenType)token), tokenCounts[token]);
+    }
+    JSONValue & nodesByClass = retval.set(L"nodesByClass", JSONValue::makeObject());
+    for(const pair<const type_index, size_t> & count : nodeCounts)
+        nodesByClass.set(demangleTypeName(get<0>(count).name()), get<1>(count));
+    os << retval.toString(true) << "\n";
+    os.flush();
+}
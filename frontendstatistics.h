@@ -0,0 +1,93 @@
+#ifndef FRONTENDSTATISTICS_H_INCLUDED
+#define FRONTENDSTATISTICS_H_INCLUDED
+
+#include <cstddef>
+#include <chrono>
+#include <ostream>
+#include <typeinfo>
+#include <typeindex>
+#include <unordered_map>
+#include "tokentype.h"
+
+using namespace std;
+
+/** per-phase front end instrumentation; every hook is a single null check while current is nullptr */
+class FrontEndStatistics final
+{
+public:
+    enum class Phase
+    {
+        Other,
+        InputRead,
+        Tokenize,
+        Parse,
+        Dump,
+        Count
+    };
+    static constexpr size_t TokenTypeCount = (size_t)TokenType::Pound + 1;
+    static FrontEndStatistics * current;
+    class PhaseTimer final
+    {
+        FrontEndStatistics * statistics;
+        Phase previousPhase;
+    public:
+        explicit PhaseTimer(Phase phase)
+            : statistics(current), previousPhase(Phase::Other)
+        {
+            if(statistics != nullptr)
+                previousPhase = statistics->switchPhase(phase);
+        }
+        PhaseTimer(const PhaseTimer &) = delete;
+        const PhaseTimer & operator =(const PhaseTimer &) = delete;
+        ~PhaseTimer()
+        {
+            if(statistics != nullptr)
+                statistics->switchPhase(previousPhase);
+        }
+    };
+private:
+    chrono::steady_clock::time_point startTime;
+    chrono::steady_clock::time_point lastSwitchTime;
+    Phase currentPhase;
+    double phaseSeconds[(size_t)Phase::Count] = {};
+    size_t tokenCounts[TokenTypeCount] = {};
+    unordered_map<type_index, size_t> nodeCounts;
+    size_t characterCount = 0;
+    size_t byteCount = 0;
+    Phase switchPhase(Phase phase);
+public:
+    FrontEndStatistics();
+    static void countToken(TokenType token)
+    {
+        if(current != nullptr)
+            current->tokenCounts[(size_t)token]++;
+    }
+    static void countCharacters(size_t count)
+    {
+        if(current != nullptr)
+            current->characterCount += count;
+    }
+    static void countBytes(size_t count)
+    {
+        if(current != nullptr)
+            current->byteCount += count;
+    }
+    template <typename T>
+    static void countNode()
+    {
+        if(current != nullptr)
+            current->nodeCounts[type_index(typeid(T))]++;
+    }
+    Phase getCurrentPhase() const
+    {
+        return currentPhase;
+    }
+    static const wchar_t * getPhaseName(Phase phase);
+    static size_t getPeakMemoryBytes();
+    size_t getTokenCount() const;
+    void dump(wostream & os);
+    /** writes UTF-8 JSON */
+    void dumpJSON(ostream & os);
+};
+
+#endif // FRONTENDSTATISTICS_H_INCLUDED
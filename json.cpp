@@ -0,0 +1,412 @@
+#include "json.h"
+#include <cstdio>
+#include <cstdlib>
+#include "parser.h"
+
+using namespace std;
+
+namespace
+{
+class JSONParser final
+{
+    static constexpr size_t MaxDepth = 1000; // parseValue recurses, so hostile input must not exhaust the stack
+    const string & text;
+    size_t index = 0;
+    size_t depth = 0;
+    Location location;
+    Location::LocationState locationState = Location::LocationState::Start;
+    int peek() const
+    {
+        return index < text.size() ? (unsigned char)text[index] : -1;
+    }
+    int next()
+    {
+        if(index >= text.size())
+            return -1;
+        location = location.getNext((unsigned char)text[index], locationState);
+        return (unsigned char)text[index++];
+    }
+    void error(wstring msg) const
+    {
+        throw ParseError(msg, LocationRange(location));
+    }
+    void skipWhitespace()
+    {
+        while(peek() == ' ' || peek() == '\t' || peek() == '\r' || peek() == '\n')
+            next();
+    }
+    void expect(const char * literal)
+    {
+        for(const char * p = literal; *p != '\0'; p++)
+        {
+            if(next() != *p)
+                error(L"invalid literal");
+        }
+    }
+    unsigned parseHex4()
+    {
+        unsigned retval = 0;
+        for(int i = 0; i < 4; i++)
+        {
+            int ch = next();
+            retval <<= 4;
+            if(ch >= '0' && ch <= '9')
+                retval += ch - '0';
+            else if(ch >= 'a' && ch <= 'f')
+                retval += ch - 'a' + 10;
+            else if(ch >= 'A' && ch <= 'F')
+                retval += ch - 'A' + 10;
+            else
+                error(L"invalid \\u escape");
+        }
+        return retval;
+    }
+    wstring parseString()
+    {
+        if(next() != '\"')
+            error(L"expected : \"");
+        string retval;
+        for(;;)
+        {
+            int ch = next();
+            if(ch == -1)
+                error(L"unterminated string");
+            if(ch == '\"')
+                break;
+            if(ch != '\\')
+            {
+                retval += (char)ch;
+                continue;
+            }
+            switch(next())
+            {
+            case '\"':
+                retval += '\"';
+                break;
+            case '\\':
+                retval += '\\';
+                break;
+            case '/':
+                retval += '/';
+                break;
+            case 'b':
+                retval += '\b';
+                break;
+            case 'f':
+                retval += '\f';
+                break;
+            case 'n':
+                retval += '\n';
+                break;
+            case 'r':
+                retval += '\r';
+                break;
+            case 't':
+                retval += '\t';
+                break;
+            case 'u':
+            {
+                unsigned codePoint = parseHex4();
+                if(codePoint >= 0xD800 && codePoint < 0xDC00 && peek() == '\\')
+                {
+                    next();
+                    if(next() != 'u')
+                        error(L"invalid surrogate pair");
+                    unsigned low = parseHex4();
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                }
+                retval += JSONValue::toUTF8(wstring(1, (wchar_t)codePoint));
+                break;
+            }
+            default:
+                error(L"invalid escape");
+            }
+        }
+        return JSONValue::fromUTF8(retval);
+    }
+public:
+    explicit JSONParser(const string & text)
+        : text(text), location(1, 0)
+    {
+    }
+    JSONValue parseValue()
+    {
+        if(++depth > MaxDepth)
+            error(L"too deeply nested");
+        skipWhitespace();
+        JSONValue retval;
+        switch(peek())
+        {
+        case '{':
+            next();
+            retval = JSONValue::makeObject();
+            skipWhitespace();
+            if(peek() == '}')
+            {
+                next();
+                break;
+            }
+            for(;;)
+            {
+                skipWhitespace();
+                wstring key = parseString();
+                skipWhitespace();
+                if(next() != ':')
+                    error(L"expected : :");
+                retval.set(key, parseValue());
+                skipWhitespace();
+                int ch = next();
+                if(ch == '}')
+                    break;
+                if(ch != ',')
+                    error(L"expected : , or }");
+            }
+            break;
+        case '[':
+            next();
+            retval = JSONValue::makeArray();
+            skipWhitespace();
+            if(peek() == ']')
+            {
+                next();
+                break;
+            }
+            for(;;)
+            {
+                retval.push(parseValue());
+                skipWhitespace();
+                int ch = next();
+                if(ch == ']')
+                    break;
+                if(ch != ',')
+                    error(L"expected : , or ]");
+            }
+            break;
+        case '\"':
+            retval = parseString();
+            break;
+        case 't':
+            expect("true");
+            retval = true;
+            break;
+        case 'f':
+            expect("false");
+            retval = false;
+            break;
+        case 'n':
+            expect("null");
+            break;
+        default:
+        {
+            size_t start = index;
+            while(peek() == '-' || peek() == '+' || peek() == '.' || peek() == 'e' || peek() == 'E' || (peek() >= '0' && peek() <= '9'))
+                next();
+            if(start == index)
+                error(L"expected : value");
+            string number = text.substr(start, index - start);
+            char * end = nullptr;
+            retval = strtod(number.c_str(), &end);
+            if(end != number.c_str() + number.size())
+                error(L"invalid number");
+            break;
+        }
+        }
+        depth--;
+        return retval;
+    }
+    void finish()
+    {
+        skipWhitespace();
+        if(peek() != -1)
+            error(L"unexpected : trailing characters");
+    }
+};
+}
+
+void JSONValue::appendString(string & output, const wstring & value)
+{
+    output += '\"';
+    for(wchar_t ch : value)
+    {
+        switch(ch)
+        {
+        case L'\"':
+            output += "\\\"";
+            break;
+        case L'\\':
+            output += "\\\\";
+            break;
+        case L'\n':
+            output += "\\n";
+            break;
+        case L'\r':
+            output += "\\r";
+            break;
+        case L'\t':
+            output += "\\t";
+            break;
+        default:
+            if((unsigned)ch < 0x20)
+            {
+                char buffer[8];
+                snprintf(buffer, sizeof(buffer), "\\u%04x", (unsigned)ch);
+                output += buffer;
+            }
+            else
+                output += JSONValue::toUTF8(wstring(1, ch));
+        }
+    }
+    output += '\"';
+}
+
+const JSONValue & JSONValue::operator [](const wstring & key) const
+{
+    static const JSONValue nullValue;
+    for(const pair<wstring, JSONValue> & member : objectValue)
+    {
+        if(get<0>(member) == key)
+            return get<1>(member);
+    }
+    return nullValue;
+}
+
+JSONValue & JSONValue::set(const wstring & key, JSONValue value)
+{
+    type = Type::Object;
+    for(pair<wstring, JSONValue> & member : objectValue)
+    {
+        if(get<0>(member) == key)
+        {
+            get<1>(member) = std::move(value);
+            return get<1>(member);
+        }
+    }
+    objectValue.push_back(make_pair(key, std::move(value)));
+    return get<1>(objectValue.back());
+}
+
+JSONValue JSONValue::parse(const string & text)
+{
+    JSONParser parser(text);
+    JSONValue retval = parser.parseValue();
+    parser.finish();
+    return retval;
+}
+
+void JSONValue::write(string & output, size_t indentLevel, bool pretty) const
+{
+    switch(type)
+    {
+    case Type::Null:
+        output += "null";
+        return;
+    case Type::Boolean:
+        output += booleanValue ? "true" : "false";
+        return;
+    case Type::Number:
+    {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.17g", numberValue);
+        output += buffer;
+        return;
+    }
+    case Type::String:
+        appendString(output, stringValue);
+        return;
+    case Type::Array:
+    case Type::Object:
+    {
+        bool isArray = type == Type::Array;
+        size_t size = isArray ? arrayValue.size() : objectValue.size();
+        output += isArray ? '[' : '{';
+        for(size_t i = 0; i < size; i++)
+        {
+            if(i > 0)
+                output += ',';
+            if(pretty)
+                output += '\n' + string((indentLevel + 1) * TabWidth, ' ');
+            if(isArray)
+                arrayValue[i].write(output, indentLevel + 1, pretty);
+            else
+            {
+                appendString(output, get<0>(objectValue[i]));
+                output += pretty ? " : " : ":";
+                get<1>(objectValue[i]).write(output, indentLevel + 1, pretty);
+            }
+        }
+        if(pretty && size > 0)
+            output += '\n' + string(indentLevel * TabWidth, ' ');
+        output += isArray ? ']' : '}';
+        return;
+    }
+    }
+}
+
+string JSONValue::toString(bool pretty) const
+{
+    string retval;
+    write(retval, 0, pretty);
+    return retval;
+}
+
+wstring JSONValue::fromUTF8(const string & text)
+{
+    wstring retval;
+    retval.reserve(text.size());
+    for(size_t i = 0; i < text.size();)
+    {
+        unsigned char ch = text[i++];
+        unsigned codePoint = ch;
+        size_t extraBytes = 0;
+        if(ch >= 0xF0)
+        {
+            codePoint = ch & 0x07;
+            extraBytes = 3;
+        }
+        else if(ch >= 0xE0)
+        {
+            codePoint = ch & 0x0F;
+            extraBytes = 2;
+        }
+        else if(ch >= 0xC0)
+        {
+            codePoint = ch & 0x1F;
+            extraBytes = 1;
+        }
+        for(; extraBytes > 0 && i < text.size() && ((unsigned char)text[i] & 0xC0) == 0x80; extraBytes--)
+            codePoint = (codePoint << 6) | ((unsigned char)text[i++] & 0x3F);
+        retval += (wchar_t)codePoint;
+    }
+    return retval;
+}
+
+string JSONValue::toUTF8(const wstring & text)
+{
+    string retval;
+    retval.reserve(text.size());
+    for(wchar_t wch : text)
+    {
+        unsigned codePoint = (unsigned)wch;
+        if(codePoint < 0x80)
+            retval += (char)codePoint;
+        else if(codePoint < 0x800)
+        {
+            retval += (char)(0xC0 | (codePoint >> 6));
+            retval += (char)(0x80 | (codePoint & 0x3F));
+        }
+        else if(codePoint < 0x10000)
+        {
+            retval += (char)(0xE0 | (codePoint >> 12));
+            retval += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+            retval += (char)(0x80 | (codePoint & 0x3F));
+        }
+        else
+        {
+            retval += (char)(0xF0 | (codePoint >> 18));
+            retval += (char)(0x80 | ((codePoint >> 12) & 0x3F));
+            retval += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+            retval += (char)(0x80 | (codePoint & 0x3F));
+        }
+    }
+    return retval;
+}
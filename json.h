@@ -0,0 +1,127 @@
+#ifndef JSON_H_INCLUDED
+#define JSON_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <ostream>
+#include "location.h"
+
+using namespace std;
+
+class JSONValue final
+{
+public:
+    enum class Type
+    {
+        Null,
+        Boolean,
+        Number,
+        String,
+        Array,
+        Object,
+    };
+private:
+    Type type;
+    bool booleanValue = false;
+    double numberValue = 0;
+    wstring stringValue;
+    vector<JSONValue> arrayValue;
+    vector<pair<wstring, JSONValue>> objectValue; // keeps insertion order so output is deterministic
+    void write(string & output, size_t indentLevel, bool pretty) const;
+public:
+    JSONValue()
+        : type(Type::Null)
+    {
+    }
+    JSONValue(nullptr_t)
+        : type(Type::Null)
+    {
+    }
+    JSONValue(bool value)
+        : type(Type::Boolean), booleanValue(value)
+    {
+    }
+    JSONValue(double value)
+        : type(Type::Number), numberValue(value)
+    {
+    }
+    JSONValue(int value)
+        : type(Type::Number), numberValue(value)
+    {
+    }
+    JSONValue(size_t value)
+        : type(Type::Number), numberValue((double)value)
+    {
+    }
+    JSONValue(wstring value)
+        : type(Type::String), stringValue(std::move(value))
+    {
+    }
+    JSONValue(const wchar_t * value)
+        : type(Type::String), stringValue(value)
+    {
+    }
+    JSONValue(const string & value)
+        : type(Type::String), stringValue(fromUTF8(value))
+    {
+    }
+    static JSONValue makeArray()
+    {
+        JSONValue retval;
+        retval.type = Type::Array;
+        return retval;
+    }
+    static JSONValue makeObject()
+    {
+        JSONValue retval;
+        retval.type = Type::Object;
+        return retval;
+    }
+    Type getType() const
+    {
+        return type;
+    }
+    bool isNull() const
+    {
+        return type == Type::Null;
+    }
+    bool getBoolean() const
+    {
+        return type == Type::Boolean && booleanValue;
+    }
+    double getNumber() const
+    {
+        return type == Type::Number ? numberValue : 0;
+    }
+    const wstring & getString() const
+    {
+        return stringValue;
+    }
+    const vector<JSONValue> & getArray() const
+    {
+        return arrayValue;
+    }
+    const vector<pair<wstring, JSONValue>> & getObject() const
+    {
+        return objectValue;
+    }
+    /** returns a null value when the key is missing or this isn't an object */
+    const JSONValue & operator [](const wstring & key) const;
+    JSONValue & set(const wstring & key, JSONValue value);
+    JSONValue & push(JSONValue value)
+    {
+        type = Type::Array;
+        arrayValue.push_back(std::move(value));
+        return arrayValue.back();
+    }
+    /** throws ParseError, including for arrays and objects nested too deeply */
+    static JSONValue parse(const string & text);
+    string toString(bool pretty = false) const;
+    /** appends value as a quoted and escaped JSON string */
+    static void appendString(string & output, const wstring & value);
+    static wstring fromUTF8(const string & text);
+    static string toUTF8(const wstring & text);
+};
+
+#endif // JSON_H_INCLUDED
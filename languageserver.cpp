@@ -0,0 +1,307 @@
+#include "languageserver.h"
+#include <cstdlib>
+#include <climits>
+#include <cmath>
+#include <memory>
+#ifdef __unix__
+#include <unistd.h>
+#endif
+#include "parser.h"
+
+using namespace std;
+
+namespace
+{
+struct RequestError final
+{
+    int code;
+    wstring message;
+};
+
+constexpr int ParseErrorCode = -32700;
+constexpr int InvalidRequestCode = -32600;
+constexpr int MethodNotFoundCode = -32601;
+constexpr int InvalidParamsCode = -32602;
+
+string getURI(const JSONValue & params)
+{
+    const JSONValue & uri = params[L"textDocument"][L"uri"];
+    if(uri.getType() != JSONValue::Type::String)
+        throw RequestError{InvalidParamsCode, L"missing textDocument.uri"};
+    return JSONValue::toUTF8(uri.getString());
+}
+
+const wstring & getText(const JSONValue & text, const wchar_t * name)
+{
+    if(text.getType() != JSONValue::Type::String)
+        throw RequestError{InvalidParamsCode, wstring(L"missing ") + name}; // an empty document must be sent as ""
+    return text.getString();
+}
+
+size_t getIndex(const JSONValue & value, const wchar_t * name)
+{
+    double number = value.getNumber();
+    if(value.getType() != JSONValue::Type::Number || !(number >= 0 && number <= (double)UINT_MAX) || floor(number) != number)
+        throw RequestError{InvalidParamsCode, wstring(L"invalid ") + name};
+    return (size_t)number;
+}
+
+string makeURI(const string & path)
+{
+    if(path.compare(0, 7, "file://") == 0)
+        return path;
+    string absolutePath = path;
+#ifdef __unix__
+    if(path.empty() || path[0] != '/')
+    {
+        unique_ptr<char, void (*)(void *)> resolved(realpath(path.c_str(), nullptr), free);
+        if(resolved != nullptr)
+            absolutePath = resolved.get();
+    }
+#endif
+    return "file://" + absolutePath;
+}
+}
+
+void LanguageServer::addFile(const string & path)
+{
+    project.updateFile(makeURI(path), Project::readFile(path));
+}
+
+bool LanguageServer::readMessage(string & message, bool & tooLarge)
+{
+    tooLarge = false;
+    string line;
+    size_t contentLength = 0;
+    bool haveHeader = false;
+    while(getline(is, line))
+    {
+        if(!line.empty() && line.back() == '\r')
+            line.erase(line.size() - 1);
+        if(line.empty())
+        {
+            if(haveHeader)
+                break;
+            continue;
+        }
+        if(!haveHeader && (line[0] == '{' || line[0] == '[' || line.find(':') == string::npos))
+        {
+            // not a header, so a whole message on one line
+            framed = false;
+            tooLarge = line.size() > MaxMessageSize;
+            message = tooLarge ? string() : std::move(line);
+            return true;
+        }
+        haveHeader = true;
+        if(line.compare(0, 15, "Content-Length:") == 0)
+            contentLength = (size_t)strtoul(line.c_str() + 15, nullptr, 10);
+    }
+    if(!haveHeader)
+        return false;
+    framed = true;
+    if(contentLength > MaxMessageSize)
+    {
+        // skip the body rather than allocating whatever the header asks for
+        tooLarge = true;
+        message.clear();
+        is.ignore((streamsize)contentLength);
+        return (size_t)is.gcount() == contentLength;
+    }
+    message.resize(contentLength);
+    is.read(&message[0], contentLength);
+    return (size_t)is.gcount() == contentLength;
+}
+
+void LanguageServer::send(const JSONValue & message)
+{
+    string text = message.toString();
+    if(framed)
+        os << "Content-Length: " << text.size() << "\r\n\r\n" << text;
+    else
+        os << text << "\n";
+    os.flush();
+}
+
+JSONValue LanguageServer::makeLocation(const string & uri, LocationRange location) const
+{
+    size_t startLine = 0, startCharacter = 0, endLine = 0, endCharacter = 0;
+    project.toPosition(uri, location.start, startLine, startCharacter);
+    project.toPosition(uri, location.end, endLine, endCharacter);
+    JSONValue start = JSONValue::makeObject();
+    start.set(L"line", startLine);
+    start.set(L"character", startCharacter);
+    JSONValue end = JSONValue::makeObject();
+    end.set(L"line", endLine);
+    end.set(L"character", endCharacter);
+    JSONValue retval = JSONValue::makeObject();
+    retval.set(L"uri", uri);
+    JSONValue & range = retval.set(L"range", JSONValue::makeObject());
+    range.set(L"start", std::move(start));
+    range.set(L"end", std::move(end));
+    return retval;
+}
+
+Location LanguageServer::getLocation(const JSONValue & params) const
+{
+    string uri = getURI(params);
+    const JSONValue & position = params[L"position"];
+    size_t line = getIndex(position[L"line"], L"position.line");
+    size_t character = getIndex(position[L"character"], L"position.character");
+    Location retval;
+    if(!project.toLocation(uri, line, character, retval))
+        throw RequestError{InvalidParamsCode, L"unknown document or position"};
+    return retval;
+}
+
+void LanguageServer::publishDiagnostics(const string & uri)
+{
+    JSONValue diagnostics = JSONValue::makeArray();
+    for(const Project::Diagnostic & diagnostic : project.getDiagnostics(uri))
+    {
+        JSONValue & item = diagnostics.push(JSONValue::makeObject());
+        item.set(L"range", makeLocation(uri, diagnostic.location)[L"range"]);
+        item.set(L"severity", 1);
+        item.set(L"message", diagnostic.message);
+    }
+    JSONValue message = JSONValue::makeObject();
+    message.set(L"jsonrpc", L"2.0");
+    message.set(L"method", L"textDocument/publishDiagnostics");
+    JSONValue & params = message.set(L"params", JSONValue::makeObject());
+    params.set(L"uri", uri);
+    params.set(L"diagnostics", std::move(diagnostics));
+    send(message);
+}
+
+void LanguageServer::publishAllDiagnostics()
+{
+    // whole-program errors can move between files, so every file is republished
+    for(const string & uri : project.getFileNames())
+        publishDiagnostics(uri);
+}
+
+JSONValue LanguageServer::handle(const wstring & method, const JSONValue & params, bool & exitNow)
+{
+    if(method == L"initialize")
+    {
+        JSONValue retval = JSONValue::makeObject();
+        JSONValue & capabilities = retval.set(L"capabilities", JSONValue::makeObject());
+        capabilities.set(L"textDocumentSync", 1); // full text on every change
+        capabilities.set(L"definitionProvider", true);
+        capabilities.set(L"implementationProvider", true);
+        JSONValue & serverInfo = retval.set(L"serverInfo", JSONValue::makeObject());
+        serverInfo.set(L"name", L"oop-interpreter");
+        return retval;
+    }
+    if(method == L"initialized")
+        return JSONValue();
+    if(method == L"shutdown")
+    {
+        shutdownRequested = true;
+        return JSONValue();
+    }
+    if(method == L"exit")
+    {
+        exitNow = true;
+        return JSONValue();
+    }
+    if(method == L"textDocument/didOpen")
+    {
+        if(project.updateFile(getURI(params), getText(params[L"textDocument"][L"text"], L"textDocument.text")))
+            publishAllDiagnostics();
+        return JSONValue();
+    }
+    if(method == L"textDocument/didChange")
+    {
+        const vector<JSONValue> & changes = params[L"contentChanges"].getArray();
+        if(changes.empty())
+            throw RequestError{InvalidParamsCode, L"missing contentChanges"};
+        if(project.updateFile(getURI(params), getText(changes.back()[L"text"], L"contentChanges text")))
+            publishAllDiagnostics();
+        return JSONValue();
+    }
+    if(method == L"textDocument/didClose")
+    {
+        // closed documents stay part of the program; only their diagnostics are cleared on the client
+        return JSONValue();
+    }
+    if(method == L"textDocument/definition")
+    {
+        Project::Definition definition;
+        if(!project.findDefinition(getURI(params), getLocation(params), definition))
+            return JSONValue();
+        return makeLocation(definition.fileName, definition.location);
+    }
+    if(method == L"textDocument/implementation")
+    {
+        JSONValue retval = JSONValue::makeArray();
+        for(const Project::Definition & definition : project.findImplementations(getURI(params), getLocation(params)))
+            retval.push(makeLocation(definition.fileName, definition.location));
+        return retval;
+    }
+    if(method == L"oop/diagnostics")
+    {
+        JSONValue retval = JSONValue::makeArray();
+        for(const string & uri : project.getFileNames())
+        {
+            for(const Project::Diagnostic & diagnostic : project.getDiagnostics(uri))
+            {
+                JSONValue item = makeLocation(uri, diagnostic.location);
+                item.set(L"message", diagnostic.message);
+                retval.push(std::move(item));
+            }
+        }
+        return retval;
+    }
+    throw RequestError{MethodNotFoundCode, L"unknown method : " + method};
+}
+
+int LanguageServer::run()
+{
+    string text;
+    bool tooLarge;
+    while(readMessage(text, tooLarge))
+    {
+        JSONValue id;
+        bool isRequest = false;
+        JSONValue response = JSONValue::makeObject();
+        response.set(L"jsonrpc", L"2.0");
+        bool exitNow = false;
+        try
+        {
+            if(tooLarge)
+            {
+                isRequest = true;
+                throw RequestError{InvalidRequestCode, L"message too large"};
+            }
+            JSONValue message;
+            try
+            {
+                message = JSONValue::parse(text);
+            }
+            catch(ParseError & e)
+            {
+                isRequest = true;
+                throw RequestError{ParseErrorCode, e.what()};
+            }
+            id = message[L"id"];
+            isRequest = !id.isNull();
+            if(message[L"method"].getType() != JSONValue::Type::String)
+                throw RequestError{InvalidRequestCode, L"missing method"};
+            JSONValue result = handle(message[L"method"].getString(), message[L"params"], exitNow);
+            response.set(L"id", id);
+            response.set(L"result", std::move(result));
+        }
+        catch(RequestError & e)
+        {
+            response.set(L"id", id);
+            JSONValue & error = response.set(L"error", JSONValue::makeObject());
+            error.set(L"code", e.code);
+            error.set(L"message", e.message);
+        }
+        if(isRequest)
+            send(response);
+        if(exitNow)
+            return shutdownRequested ? 0 : 1;
+    }
+    return 0;
+}
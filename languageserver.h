@@ -0,0 +1,47 @@
+#ifndef LANGUAGESERVER_H_INCLUDED
+#define LANGUAGESERVER_H_INCLUDED
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include "json.h"
+#include "project.h"
+
+using namespace std;
+
+/** long running JSON-RPC 2.0 server keeping a Project in memory between requests
+ *
+ * messages are read either with Content-Length headers, as language server clients send them,
+ * or one per line for scripting; replies use the same framing as the request they answer.
+ * supports initialize, shutdown, exit, textDocument/didOpen, didChange (full text), didClose,
+ * textDocument/definition, textDocument/implementation and oop/diagnostics;
+ * textDocument/publishDiagnostics is sent after every change
+ */
+class LanguageServer final
+{
+    static constexpr size_t MaxMessageSize = (size_t)64 << 20;
+    istream & is;
+    ostream & os;
+    Project project;
+    bool framed = true;
+    bool shutdownRequested = false;
+    /** tooLarge is set instead of reading a message over MaxMessageSize */
+    bool readMessage(string & message, bool & tooLarge);
+    void send(const JSONValue & message);
+    void publishDiagnostics(const string & uri);
+    void publishAllDiagnostics();
+    JSONValue makeLocation(const string & uri, LocationRange location) const;
+    Location getLocation(const JSONValue & params) const;
+    JSONValue handle(const wstring & method, const JSONValue & params, bool & exitNow);
+public:
+    LanguageServer(istream & is, ostream & os)
+        : is(is), os(os)
+    {
+    }
+    /** adds a file from disk before serving; throws Exception if it can't be read */
+    void addFile(const string & path);
+    /** serves until exit or the end of input; returns the process exit code */
+    int run();
+};
+
+#endif // LANGUAGESERVER_H_INCLUDED
@@ -135,6 +135,10 @@ struct LocationRange
         end = end.getNext(ch, state);
         return *this;
     }
+    bool contains(Location location) const
+    {
+        return start <= location && location < end;
+    }
     wstring toString() const
     {
         return start.toString();
@@ -1,14 +1,191 @@
 #include <iostream>
 #include <fstream>
+#include <string>
+#include <cstdlib>
+#include <cstdio>
+#include <iterator>
 #include "parser.h"
+#include "classhierarchy.h"
+#include "frontendstatistics.h"
+#include "allocationtracker.h"
+#include "utf8outputbuffer.h"
+#include "languageserver.h"
+#include "projectwatcher.h"
 
 using namespace std;
 
-int main()
+int main(int argc, char ** argv)
 {
-    Parser parser(make_shared<IStreamParserInput>(make_shared<wifstream>("test.txt")));
-    shared_ptr<ASTNode> ast = parser.run();
+    bool showPoolStatistics = false;
+    bool showClassHierarchy = false;
+    bool showStatistics = false;
+    size_t allocationSiteCount = 0;
+    string statisticsFileName;
+    string binaryExportFileName;
+    string jsonExportFileName;
+    string binaryReadFileName;
+    string inputFileName = "test.txt";
+    vector<string> inputFileNames;
+    bool runServer = false;
+    bool watch = false;
+    for(int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if(arg == "--pool-stats")
+            showPoolStatistics = true;
+        else if(arg == "--class-hierarchy")
+            showClassHierarchy = true;
+        else if(arg == "--stats")
+            showStatistics = true;
+        else if(arg.compare(0, 8, "--stats=") == 0)
+        {
+            showStatistics = true;
+            statisticsFileName = arg.substr(8);
+        }
+        else if(arg == "--server")
+            runServer = true;
+        else if(arg == "--watch")
+            watch = true;
+        else if(arg.compare(0, 16, "--export-binary=") == 0)
+            binaryExportFileName = arg.substr(16);
+        else if(arg.compare(0, 14, "--export-json=") == 0)
+            jsonExportFileName = arg.substr(14);
+        else if(arg.compare(0, 14, "--read-binary=") == 0)
+            binaryReadFileName = arg.substr(14);
+        else if(arg == "--alloc-stats")
+            allocationSiteCount = 20;
+        else if(arg.compare(0, 14, "--alloc-stats=") == 0)
+        {
+            allocationSiteCount = (size_t)atol(arg.c_str() + 14);
+            if(allocationSiteCount == 0)
+            {
+                wcerr << L"invalid allocation site count : " << wstring(arg.begin(), arg.end()) << endl;
+                return 1;
+            }
+        }
+        else if(arg.compare(0, 2, "--") == 0)
+        {
+            wcerr << L"unknown option : " << wstring(arg.begin(), arg.end()) << endl;
+            return 1;
+        }
+        else
+        {
+            inputFileName = arg;
+            inputFileNames.push_back(arg);
+        }
+    }
+    if(runServer)
+    {
+        ios::sync_with_stdio(false);
+        LanguageServer server(cin, cout);
+        try
+        {
+            for(const string & fileName : inputFileNames)
+                server.addFile(fileName);
+        }
+        catch(Exception & e)
+        {
+            wcerr << L"Error : " << e.what() << endl;
+            return 1;
+        }
+        return server.run();
+    }
+    if(!binaryReadFileName.empty())
+    {
+        try
+        {
+            ifstream is(binaryReadFileName, ios::binary);
+            if(!is)
+                throw Exception(L"can't open " + wstring(binaryReadFileName.begin(), binaryReadFileName.end()));
+            string data{istreambuf_iterator<char>(is), istreambuf_iterator<char>()};
+            BinaryASTReader reader(std::move(data));
+            wcout << L"root : " << getASTNodeKindName(reader.getRootKind()) << L"\n";
+            wcout << L"names : " << reader.getNameCount() << L"\n";
+            for(size_t i = 0; i < reader.getNameCount(); i++)
+                wcout << L"    " << i << L" : " << reader.getName(i) << L"\n";
+            wcout.flush();
+        }
+        catch(Exception & e)
+        {
+            wcerr << L"Error : " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+    if(watch)
+    {
+        if(inputFileNames.empty())
+            inputFileNames.push_back(inputFileName);
+        return ProjectWatcher(inputFileNames, wcout).run();
+    }
+    FrontEndStatistics statistics;
+    AllocationTracker allocationTracker(true);
+    if(showStatistics || allocationSiteCount > 0)
+        FrontEndStatistics::current = &statistics; // the allocation tracker needs the current phase
+    if(allocationSiteCount > 0)
+        AllocationTracker::current = &allocationTracker;
+    if(showStatistics)
+    {
+        ifstream file(inputFileName, ios::binary | ios::ate);
+        if(file)
+            FrontEndStatistics::countBytes((size_t)file.tellg());
+    }
+    Parser parser(make_shared<IStreamParserInput>(make_shared<wifstream>(inputFileName)));
+    shared_ptr<ASTNode> ast;
+    {
+        FrontEndStatistics::PhaseTimer timer(FrontEndStatistics::Phase::Parse);
+        ast = parser.run();
+    }
+    wcout.flush();
+    UTF8OutputBuffer outputBuffer(fileno(stdout));
+    wostream output(&outputBuffer);
     if(ast)
-        ast->dump(wcout);
+    {
+        FrontEndStatistics::PhaseTimer timer(FrontEndStatistics::Phase::Dump);
+        ast->dump(output);
+        output.flush();
+    }
+    if(ast && !binaryExportFileName.empty())
+    {
+        ofstream os(binaryExportFileName, ios::binary);
+        BinaryASTExporter exporter(os);
+        ast->exportTo(exporter);
+        exporter.finish();
+        if(!os)
+            wcerr << L"can't write " << wstring(binaryExportFileName.begin(), binaryExportFileName.end()) << endl;
+    }
+    if(ast && !jsonExportFileName.empty())
+    {
+        ofstream os(jsonExportFileName, ios::binary);
+        JSONASTExporter exporter(os);
+        ast->exportTo(exporter);
+        exporter.finish();
+        if(!os)
+            wcerr << L"can't write " << wstring(jsonExportFileName.begin(), jsonExportFileName.end()) << endl;
+    }
+    if(ast && showClassHierarchy)
+    {
+        ClassHierarchy hierarchy(ast);
+        hierarchy.dump(output);
+        for(const ClassHierarchy::Error & e : hierarchy.getErrors())
+            output << L"\nError : " << e.what() << L"\n";
+        output.flush();
+    }
+    AllocationTracker::current = nullptr;
+    FrontEndStatistics::current = nullptr;
+    if(showPoolStatistics)
+        PoolStatistics::dump(wcerr);
+    if(allocationSiteCount > 0)
+        allocationTracker.dump(wcerr, allocationSiteCount);
+    if(showStatistics)
+    {
+        if(statisticsFileName.empty())
+            statistics.dump(wcerr);
+        else
+        {
+            ofstream os(statisticsFileName, ios::binary);
+            statistics.dumpJSON(os);
+        }
+    }
     return 0;
 }
@@ -5,6 +5,7 @@
 #include "astnamespace.h"
 #include "astidentifier.h"
 #include "astclass.h"
+#include "aststructure.h"
 
 using namespace std;
 
@@ -217,6 +218,7 @@ void Parser::Tokenizer::parseString()
             {
                 tokenValue += curChar();
                 tokenLocation += curLocation();
+                nextChar();
             }
             else
                 return;
@@ -380,9 +382,15 @@ unordered_map<wstring, TokenType> Parser::Tokenizer::makeKeywordMap()
     return retval;
 }
 
-void Parser::Tokenizer::checkForKeyword()
+const unordered_map<wstring, TokenType> & Parser::Tokenizer::getKeywordMap()
 {
     thread_local unordered_map<wstring, TokenType> keywordMap = makeKeywordMap();
+    return keywordMap;
+}
+
+void Parser::Tokenizer::checkForKeyword()
+{
+    const unordered_map<wstring, TokenType> & keywordMap = getKeywordMap();
     auto iter = keywordMap.find(tokenValue);
     if(iter == keywordMap.end())
         return;
@@ -405,27 +413,27 @@ void Parser::Tokenizer::checkForKeyword()
     if(iter == keywordMap.end())
     {
         TokenType tempToken = token;
-        wstring tempTokenValue = tokenValue;
+        wstring tempTokenValue = std::move(tokenValue);
         LocationRange tempTokenLocation = tokenLocation;
         token = TokenType::Identifier;
-        tokenValue = get<0>(v);
+        tokenValue = std::move(get<0>(v));
         tokenLocation = get<1>(v);
-        putback(tempToken, tempTokenValue, tempTokenLocation);
+        putback(tempToken, std::move(tempTokenValue), tempTokenLocation);
         return;
     }
     tokenLocation += get<1>(v);
-    tokenValue = newTokenValue;
+    tokenValue = std::move(newTokenValue);
     token = get<1>(*iter);
 }
 
-void Parser::Tokenizer::nextToken()
+void Parser::Tokenizer::readToken()
 {
     if(putbackToken != TokenType::Eof)
     {
         token = putbackToken;
         putbackToken = TokenType::Eof;
         tokenLocation = putbackTokenLocation;
-        tokenValue = putbackTokenValue;
+        tokenValue = std::move(putbackTokenValue);
         if(token == TokenType::Identifier)
             checkForKeyword();
         return;
@@ -464,7 +472,7 @@ void Parser::Tokenizer::nextToken()
     {
         auto v = parseWord();
         token = TokenType::Identifier;
-        tokenValue = get<0>(v);
+        tokenValue = std::move(get<0>(v));
         tokenLocation = get<1>(v);
         checkForKeyword();
         return;
@@ -657,17 +665,13 @@ shared_ptr<ASTNode> Parser::parseNamespace(vector<Token> modifiers)
     vector<shared_ptr<ASTNamespace>> imports;
     location += parseBlockInternal(nodes, variables, imports);
     location += getTokenOrError({TokenType::EndNamespace});
-    shared_ptr<ASTNode> retval = make_shared<ASTNamespace>(location, name, std::move(imports), std::move(variables), std::move(modifiers), std::move(nodes));
-    for(shared_ptr<ASTNode> node : retval->nodes)
-    {
-        node->setLexicalParent(retval);
-    }
+    shared_ptr<ASTNode> retval = makeASTNode<ASTNamespace>(location, std::move(name), std::move(imports), std::move(variables), std::move(modifiers), std::move(nodes));
     return retval;
 }
 
 shared_ptr<ASTNode> Parser::parseClass(vector<Token> modifiers)
 {
-    validateModifiers(modifiers, {}, getTokenAsPrintableString());
+    validateModifiers(modifiers, {TokenType::Friend, TokenType::NotInheritable, TokenType::Private, TokenType::Protected, TokenType::Public}, getTokenAsPrintableString());
     LocationRange location = getTokenOrError({TokenType::Class});
     shared_ptr<ASTPeriod> name = parseNamePath();
     location += name->getLocation();
@@ -679,6 +683,18 @@ shared_ptr<ASTNode> Parser::parseClass(vector<Token> modifiers)
         inherits = parseNamePath();
         location += inherits->getLocation();
     }
+    vector<shared_ptr<ASTPeriod>> implements = parseImplements(location);
+    vector<shared_ptr<ASTNode>> nodes;
+    unordered_map<wstring, shared_ptr<ASTNode>> variables;
+    vector<shared_ptr<ASTNamespace>> imports;
+    location += parseBlockInternal(nodes, variables, imports);
+    location += getTokenOrError({TokenType::EndClass});
+    shared_ptr<ASTNode> retval = makeASTNode<ASTClass>(location, name, inherits, implements, std::move(imports), std::move(variables), std::move(modifiers), std::move(nodes));
+    return retval;
+}
+
+vector<shared_ptr<ASTPeriod>> Parser::parseImplements(LocationRange & location)
+{
     vector<shared_ptr<ASTPeriod>> implements;
     if(curTokenType() == TokenType::Implements)
     {
@@ -689,18 +705,26 @@ shared_ptr<ASTNode> Parser::parseClass(vector<Token> modifiers)
             implements.push_back(parseNamePath());
             location += implements.back()->getLocation();
         }
-        while(nextTokenType() == TokenType::Comma);
+        while(curTokenType() == TokenType::Comma);
     }
+    return implements;
+}
+
+shared_ptr<ASTNode> Parser::parseStructure(vector<Token> modifiers)
+{
+    validateModifiers(modifiers, {TokenType::Friend, TokenType::Private, TokenType::Protected, TokenType::Public}, getTokenAsPrintableString());
+    LocationRange location = getTokenOrError({TokenType::Structure});
+    shared_ptr<ASTPeriod> name = parseNamePath();
+    location += name->getLocation();
+    if(curTokenType() == TokenType::Inherits)
+        invalidWith(curToken(), ::getTokenAsPrintableString(TokenType::Structure));
+    vector<shared_ptr<ASTPeriod>> implements = parseImplements(location);
     vector<shared_ptr<ASTNode>> nodes;
     unordered_map<wstring, shared_ptr<ASTNode>> variables;
     vector<shared_ptr<ASTNamespace>> imports;
     location += parseBlockInternal(nodes, variables, imports);
-    location += getTokenOrError({TokenType::EndClass});
-    shared_ptr<ASTNode> retval = make_shared<ASTClass>(location, name, inherits, implements, std::move(imports), std::move(variables), std::move(modifiers), std::move(nodes));
-    for(shared_ptr<ASTNode> node : retval->nodes)
-    {
-        node->setLexicalParent(retval);
-    }
+    location += getTokenOrError({TokenType::EndStructure});
+    shared_ptr<ASTNode> retval = makeASTNode<ASTStructure>(location, name, implements, std::move(imports), std::move(variables), std::move(modifiers), std::move(nodes));
     return retval;
 }
 
@@ -758,6 +782,13 @@ LocationRange Parser::parseBlockInternal(vector<shared_ptr<ASTNode>> & nodes, un
             location += nodes.back()->getLocation();
             break;
         }
+        case TokenType::Structure:
+        {
+            nodes.push_back(parseStructure(modifiers));
+            modifiers.clear();
+            location += nodes.back()->getLocation();
+            break;
+        }
         case TokenType::EndBlock:
         case TokenType::EndClass:
         case TokenType::EndEnum:
@@ -767,6 +798,7 @@ LocationRange Parser::parseBlockInternal(vector<shared_ptr<ASTNode>> & nodes, un
         case TokenType::EndNamespace:
         case TokenType::EndOperator:
         case TokenType::EndSelect:
+        case TokenType::EndStructure:
         case TokenType::Eof:
         {
             validateModifiers(modifiers, {}, getTokenAsPrintableString());
@@ -784,11 +816,7 @@ shared_ptr<ASTNode> Parser::parseBlock()
     unordered_map<wstring, shared_ptr<ASTNode>> variables;
     vector<shared_ptr<ASTNamespace>> imports;
     LocationRange location = parseBlockInternal(nodes, variables, imports);
-    shared_ptr<ASTNode> retval = make_shared<ASTBlock>(location, std::move(imports), std::move(variables), std::move(nodes));
-    for(shared_ptr<ASTNode> node : retval->nodes)
-    {
-        node->setLexicalParent(retval);
-    }
+    shared_ptr<ASTNode> retval = makeASTNode<ASTBlock>(location, std::move(imports), std::move(variables), std::move(nodes));
     return retval;
 }
 
@@ -805,49 +833,54 @@ shared_ptr<ASTPeriod> Parser::parseNamePath()
     if(curTokenType() == TokenType::Global || curTokenType() == TokenType::Identifier || curTokenType() == TokenType::Object || curTokenType() == TokenType::Me || curTokenType() == TokenType::MyBase || curTokenType() == TokenType::MyClass)
     {
         if(curTokenType() == TokenType::Identifier)
-            nodes.push_back(make_shared<ASTIdentifier>(curToken()));
+            nodes.push_back(makeASTNode<ASTIdentifier>(curToken()));
         else if(curTokenType() == TokenType::Object)
-            nodes.push_back(make_shared<ASTObjectIdentifier>(location));
+            nodes.push_back(makeASTNode<ASTObjectIdentifier>(location));
         else
-            nodes.push_back(make_shared<ASTSpecialIdentifier>(curTokenLocation(), curTokenType()));
+            nodes.push_back(makeASTNode<ASTSpecialIdentifier>(curTokenLocation(), curTokenType()));
         location += curTokenLocation();
         nextTokenType();
         while(curTokenType() == TokenType::Period)
         {
             location += curTokenLocation();
             nextTokenType();
-            if(curTokenType() != TokenType::Identifier && (curTokenType() != TokenType::Object || nodes.size() != 1 || dynamic_pointer_cast<ASTSpecialIdentifier>(nodes[0]) == nullptr))
+            if(curTokenType() != TokenType::Identifier && (curTokenType() != TokenType::Object || nodes.size() != 1 || nodes[0]->getKind() != ASTNodeKind::SpecialIdentifier))
             {
-                if(nodes.size() == 1 && dynamic_pointer_cast<ASTSpecialIdentifier>(nodes[0]) != nullptr)
+                if(nodes.size() == 1 && nodes[0]->getKind() == ASTNodeKind::SpecialIdentifier)
                     expected({TokenType::Object, TokenType::Identifier}, curTokenLocation());
                 else
                     expected({TokenType::Identifier}, curTokenLocation());
             }
             if(curTokenType() == TokenType::Object)
-                nodes.push_back(make_shared<ASTObjectIdentifier>(curTokenLocation()));
+                nodes.push_back(makeASTNode<ASTObjectIdentifier>(curTokenLocation()));
             else
-                nodes.push_back(make_shared<ASTIdentifier>(curToken()));
+                nodes.push_back(makeASTNode<ASTIdentifier>(curToken()));
             location += curTokenLocation();
             nextTokenType();
         }
     }
     else if(!startsWithPeriod)
         expected({TokenType::Global, TokenType::Object, TokenType::Identifier, TokenType::Period, TokenType::Me, TokenType::MyBase, TokenType::MyClass}, curTokenLocation());
-    return make_shared<ASTPeriod>(location, startsWithPeriod, nodes);
+    return makeASTNode<ASTPeriod>(location, startsWithPeriod, nodes);
+}
+
+shared_ptr<ASTNode> Parser::parse()
+{
+    vector<shared_ptr<ASTNode>> nodes;
+    unordered_map<wstring, shared_ptr<ASTNode>> variables;
+    vector<shared_ptr<ASTNamespace>> imports;
+    LocationRange location = parseBlockInternal(nodes, variables, imports);
+    shared_ptr<ASTNode> retval = makeASTNode<ASTGlobalBlock>(location, std::move(imports), std::move(variables), std::move(nodes));
+    if(curTokenType() != TokenType::Eof)
+        unexpected(curToken());
+    return retval;
 }
 
 shared_ptr<ASTNode> Parser::run()
 {
     try
     {
-        vector<shared_ptr<ASTNode>> nodes;
-        unordered_map<wstring, shared_ptr<ASTNode>> variables;
-        vector<shared_ptr<ASTNamespace>> imports;
-        LocationRange location = parseBlockInternal(nodes, variables, imports);
-        shared_ptr<ASTNode> retval = make_shared<ASTGlobalBlock>(location, std::move(imports), std::move(variables), std::move(nodes));
-        if(curTokenType() != TokenType::Eof)
-            unexpected(curToken());
-        return retval;
+        return parse();
     }
     catch(Exception & e)
     {
@@ -13,6 +13,8 @@
 #include <unordered_map>
 #include "location.h"
 #include "tokentype.h"
+#include "frontendstatistics.h"
+#include "allocationtracker.h"
 #include "astnode.h"
 #include "astnamespace.h"
 #include "astperiod.h"
@@ -27,10 +29,10 @@ class ParserInput
     LocationRange location;
     Location::LocationState locationState = Location::LocationState::Start;
 protected:
-    virtual wstring getNextBuffer() = 0;
+    virtual void getNextBuffer(wstring & buffer) = 0;
 public:
     ParserInput(wstring buffer)
-        : buffer(buffer), currentChar(buffer.size() > 0 ? buffer[0] : WEOF), currentBufferIndex(buffer.size() > 0 ? 1 : 0), locationState(Location::LocationState::Start)
+        : buffer(std::move(buffer)), currentChar(this->buffer.size() > 0 ? this->buffer[0] : WEOF), currentBufferIndex(this->buffer.size() > 0 ? 1 : 0), locationState(Location::LocationState::Start)
     {
         location = LocationRange().advance(currentChar, locationState);
     }
@@ -49,7 +51,7 @@ public:
         if(currentBufferIndex >= buffer.size())
         {
             currentBufferIndex = 0;
-            buffer = getNextBuffer();
+            getNextBuffer(buffer);
         }
         if(buffer.size() == 0)
             currentChar = WEOF;
@@ -76,25 +78,35 @@ public:
 class IStreamParserInput : public ParserInput
 {
 private:
-    static wstring read(wistream & is)
+    static constexpr size_t BufferSize = 4096;
+    static void read(wistream & is, wstring & buffer)
     {
+        FrontEndStatistics::PhaseTimer timer(FrontEndStatistics::Phase::InputRead);
         if(!&is || !is)
-            return L"";
+        {
+            buffer.clear();
+            return;
+        }
+        buffer.resize(BufferSize);
+        is.read(&buffer[0], buffer.size());
+        buffer.resize(is.gcount());
+        FrontEndStatistics::countCharacters(buffer.size());
+    }
+    static wstring read(wistream & is)
+    {
         wstring retval;
-        retval.resize(256);
-        is.read(&retval[0], retval.size());
-        retval.resize(is.gcount());
+        read(is, retval);
         return retval;
     }
     shared_ptr<wistream> is;
 protected:
-    virtual wstring getNextBuffer() override
+    virtual void getNextBuffer(wstring & buffer) override
     {
-        return read(*is.get());
+        read(*is.get(), buffer);
     }
 public:
     IStreamParserInput(shared_ptr<wistream> is)
-        : ParserInput(read(*is.get())), is(is)
+        : ParserInput(read(*is.get())), is(std::move(is))
     {
     }
     IStreamParserInput(wistream & is)
@@ -103,6 +115,20 @@ public:
     }
 };
 
+class StringParserInput : public ParserInput
+{
+protected:
+    virtual void getNextBuffer(wstring & buffer) override
+    {
+        buffer.clear();
+    }
+public:
+    StringParserInput(wstring text)
+        : ParserInput(std::move(text))
+    {
+    }
+};
+
 class Exception
 {
     wstring msg;
@@ -123,14 +149,16 @@ public:
 struct ParseError : public Exception
 {
     const LocationRange location;
+    const wstring message; // what() without the location
     ParseError(wstring msg, LocationRange location)
-        : Exception(location.toString() + L" : " + msg), location(location)
+        : Exception(location.toString() + L" : " + msg), location(location), message(msg)
     {
     }
 };
 
 class Parser
 {
+    friend class Benchmark;
 private:
     static void error(wstring msg, LocationRange location)
     {
@@ -252,21 +280,30 @@ private:
         LocationRange putbackTokenLocation;
         wstring putbackTokenValue;
         static unordered_map<wstring, TokenType> makeKeywordMap();
+        static const unordered_map<wstring, TokenType> & getKeywordMap();
         void checkForKeyword();
         void putback(TokenType tokenType, wstring value, LocationRange location)
         {
             putbackToken = token;
-            putbackTokenValue = tokenValue;
+            putbackTokenValue = std::move(tokenValue);
             putbackTokenLocation = tokenLocation;
             token = tokenType;
-            tokenValue = value;
+            tokenValue = std::move(value);
             tokenLocation = location;
         }
-        void nextToken();
+        void readToken();
+        void nextToken()
+        {
+            FrontEndStatistics::PhaseTimer timer(FrontEndStatistics::Phase::Tokenize);
+            AllocationTracker::Scope<Token> allocationScope;
+            readToken();
+            FrontEndStatistics::countToken(token);
+        }
     public:
         Tokenizer(shared_ptr<ParserInput> parserInput)
             : parserInput(parserInput), putbackChar(WEOF), token(TokenType::LineStart), tokenLocation(Location()), tokenValue(L""), putbackToken(TokenType::Eof)
         {
+            getKeywordMap(); // built here so --alloc-stats doesn't charge it to the first Token
         }
         TokenType currentTokenType() const
         {
@@ -276,7 +313,7 @@ private:
         {
             return tokenLocation;
         }
-        wstring currentTokenValue() const
+        const wstring & currentTokenValue() const
         {
             return tokenValue;
         }
@@ -290,7 +327,7 @@ private:
             nextToken();
             return tokenLocation;
         }
-        wstring nextTokenValue()
+        const wstring & nextTokenValue()
         {
             nextToken();
             return tokenValue;
@@ -318,7 +355,7 @@ private:
             return putbackTokenLocation;
         return tokenizer.currentTokenLocation();
     }
-    wstring curTokenValue() const
+    const wstring & curTokenValue() const
     {
         if(putbackTokenType != TokenType::Eof)
             return putbackTokenValue;
@@ -352,7 +389,7 @@ private:
         }
         return tokenizer.nextTokenLocation();
     }
-    wstring nextTokenValue()
+    const wstring & nextTokenValue()
     {
         if(putbackTokenType != TokenType::Eof)
         {
@@ -372,7 +409,7 @@ private:
     void putback(TokenType tokenType, wstring tokenValue, LocationRange tokenLocation)
     {
         putbackTokenType = tokenType;
-        putbackTokenValue = tokenValue;
+        putbackTokenValue = std::move(tokenValue);
         putbackTokenLocation = tokenLocation;
     }
     LocationRange getTokenOrError(initializer_list<TokenType> tokenTypes)
@@ -421,10 +458,15 @@ private:
     }
     shared_ptr<ASTPeriod> parseNamePath();
     shared_ptr<ASTNode> parseNamespace(vector<Token> modifiers);
+    vector<shared_ptr<ASTPeriod>> parseImplements(LocationRange & location);
     shared_ptr<ASTNode> parseClass(vector<Token> modifiers);
+    shared_ptr<ASTNode> parseStructure(vector<Token> modifiers);
     LocationRange parseBlockInternal(vector<shared_ptr<ASTNode>> & nodes, unordered_map<wstring, shared_ptr<ASTNode>> & variables, vector<shared_ptr<ASTNamespace>> & imports);
     shared_ptr<ASTNode> parseBlock();
 public:
+    /** throws ParseError */
+    shared_ptr<ASTNode> parse();
+    /** prints the error and returns nullptr if the input doesn't parse */
     shared_ptr<ASTNode> run();
 };
 
@@ -0,0 +1,201 @@
+#include "poolallocator.h"
+#include <mutex>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <new>
+#include "demangle.h"
+#include "allocationtracker.h"
+
+using namespace std;
+
+namespace
+{
+struct FreeBlock
+{
+    FreeBlock * next;
+};
+
+struct GlobalPool
+{
+    mutex lock;
+    FreeBlock * freeLists[Pool::SizeClassCount] = {};
+    atomic<size_t> slabCount;
+    PoolStatistics * statistics = nullptr;
+    chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+    GlobalPool()
+        : slabCount(0)
+    {
+    }
+};
+
+// never destroyed : blocks can be freed by static destructors and by threads outliving main
+GlobalPool & getGlobalPool()
+{
+    static GlobalPool * globalPool = new GlobalPool;
+    return *globalPool;
+}
+
+struct ThreadCache
+{
+    FreeBlock * freeLists[Pool::SizeClassCount] = {};
+    FreeBlock * refill(size_t sizeClass)
+    {
+        GlobalPool & globalPool = getGlobalPool();
+        {
+            lock_guard<mutex> lockIt(globalPool.lock);
+            if(globalPool.freeLists[sizeClass] != nullptr)
+            {
+                FreeBlock * retval = globalPool.freeLists[sizeClass];
+                globalPool.freeLists[sizeClass] = nullptr;
+                return retval;
+            }
+        }
+        size_t blockSize = (sizeClass + 1) * Pool::Granularity;
+        char * slab;
+        {
+            AllocationTracker::Scope<Pool> allocationScope; // slabs are shared by every class in this size class
+            slab = static_cast<char *>(::operator new(Pool::SlabSize));
+        }
+        globalPool.slabCount.fetch_add(1, memory_order_relaxed);
+        FreeBlock * retval = nullptr;
+        for(size_t offset = Pool::SlabSize - Pool::SlabSize % blockSize; offset >= blockSize; offset -= blockSize)
+        {
+            FreeBlock * block = reinterpret_cast<FreeBlock *>(slab + offset - blockSize);
+            block->next = retval;
+            retval = block;
+        }
+        return retval;
+    }
+    void flush()
+    {
+        GlobalPool & globalPool = getGlobalPool();
+        lock_guard<mutex> lockIt(globalPool.lock);
+        for(size_t sizeClass = 0; sizeClass < Pool::SizeClassCount; sizeClass++)
+        {
+            FreeBlock * head = freeLists[sizeClass];
+            if(head == nullptr)
+                continue;
+            FreeBlock * tail = head;
+            while(tail->next != nullptr)
+                tail = tail->next;
+            tail->next = globalPool.freeLists[sizeClass];
+            globalPool.freeLists[sizeClass] = head;
+            freeLists[sizeClass] = nullptr;
+        }
+    }
+};
+
+thread_local ThreadCache * currentThreadCache = nullptr;
+
+struct ThreadCacheOwner
+{
+    ThreadCache cache;
+    ThreadCacheOwner()
+    {
+        currentThreadCache = &cache;
+    }
+    ~ThreadCacheOwner()
+    {
+        currentThreadCache = nullptr;
+        cache.flush();
+    }
+};
+
+ThreadCache * getThreadCache()
+{
+    if(currentThreadCache != nullptr)
+        return currentThreadCache;
+    thread_local ThreadCacheOwner owner;
+    return currentThreadCache;
+}
+}
+
+void * Pool::allocate(size_t size)
+{
+    if(size == 0)
+        size = 1;
+    if(size > MaxBlockSize)
+        return ::operator new(size);
+    size_t sizeClass = getSizeClass(size);
+    ThreadCache * threadCache = getThreadCache();
+    if(threadCache == nullptr) // thread is exiting
+    {
+        ThreadCache temporaryCache;
+        FreeBlock * retval = temporaryCache.refill(sizeClass);
+        temporaryCache.freeLists[sizeClass] = retval->next;
+        temporaryCache.flush();
+        return retval;
+    }
+    FreeBlock * retval = threadCache->freeLists[sizeClass];
+    if(retval == nullptr)
+        retval = threadCache->refill(sizeClass);
+    threadCache->freeLists[sizeClass] = retval->next;
+    return retval;
+}
+
+void Pool::deallocate(void * block, size_t size)
+{
+    if(block == nullptr)
+        return;
+    if(size == 0)
+        size = 1;
+    if(size > MaxBlockSize)
+    {
+        ::operator delete(block);
+        return;
+    }
+    size_t sizeClass = getSizeClass(size);
+    FreeBlock * freeBlock = static_cast<FreeBlock *>(block);
+    ThreadCache * threadCache = getThreadCache();
+    if(threadCache == nullptr) // thread is exiting
+    {
+        GlobalPool & globalPool = getGlobalPool();
+        lock_guard<mutex> lockIt(globalPool.lock);
+        freeBlock->next = globalPool.freeLists[sizeClass];
+        globalPool.freeLists[sizeClass] = freeBlock;
+        return;
+    }
+    freeBlock->next = threadCache->freeLists[sizeClass];
+    threadCache->freeLists[sizeClass] = freeBlock;
+}
+
+size_t Pool::getSlabCount()
+{
+    return getGlobalPool().slabCount.load(memory_order_relaxed);
+}
+
+PoolStatistics::PoolStatistics(const char * name)
+    : name(name), liveCount(0), allocationCount(0)
+{
+    GlobalPool & globalPool = getGlobalPool();
+    lock_guard<mutex> lockIt(globalPool.lock);
+    next = globalPool.statistics;
+    globalPool.statistics = this;
+}
+
+void PoolStatistics::dump(wostream & os)
+{
+    GlobalPool & globalPool = getGlobalPool();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - globalPool.startTime).count();
+    vector<const PoolStatistics *> statisticsList;
+    {
+        lock_guard<mutex> lockIt(globalPool.lock);
+        for(const PoolStatistics * statistics = globalPool.statistics; statistics != nullptr; statistics = statistics->next)
+            statisticsList.push_back(statistics);
+    }
+    ios_base::fmtflags flags = os.flags();
+    streamsize precision = os.precision();
+    os << L"Pool Statistics (" << fixed << setprecision(3) << seconds << L" seconds)\n";
+    os << left << setw(24) << L"Class" << right << setw(12) << L"Live" << setw(14) << L"Allocations" << setw(16) << L"Allocations/s" << L"\n";
+    for(auto i = statisticsList.rbegin(); i != statisticsList.rend(); ++i)
+    {
+        size_t allocations = (*i)->allocationCount.load(memory_order_relaxed);
+        os << left << setw(24) << demangleTypeName((*i)->name) << right << setw(12) << (*i)->liveCount.load(memory_order_relaxed);
+        os << setw(14) << allocations << setw(16) << setprecision(1) << (seconds > 0 ? allocations / seconds : 0.0) << L"\n";
+    }
+    os << L"Slabs : " << Pool::getSlabCount() << L" (" << Pool::getSlabCount() * Pool::SlabSize / 1024 << L" KiB)" << endl;
+    os.flags(flags);
+    os.precision(precision);
+}
@@ -0,0 +1,96 @@
+#ifndef POOLALLOCATOR_H_INCLUDED
+#define POOLALLOCATOR_H_INCLUDED
+
+#include <cstddef>
+#include <atomic>
+#include <ostream>
+#include <typeinfo>
+
+using namespace std;
+
+class Pool final
+{
+public:
+    static constexpr size_t Granularity = 16;
+    static constexpr size_t MaxBlockSize = 512;
+    static constexpr size_t SizeClassCount = MaxBlockSize / Granularity;
+    static constexpr size_t SlabSize = 64 * 1024;
+    static size_t getSizeClass(size_t size)
+    {
+        return (size + Granularity - 1) / Granularity - 1;
+    }
+    static void * allocate(size_t size);
+    static void deallocate(void * block, size_t size);
+    static size_t getSlabCount();
+};
+
+class PoolStatistics final
+{
+private:
+    const char * name;
+    atomic<size_t> liveCount;
+    atomic<size_t> allocationCount;
+    PoolStatistics * next;
+public:
+    explicit PoolStatistics(const char * name);
+    PoolStatistics(const PoolStatistics &) = delete;
+    const PoolStatistics & operator =(const PoolStatistics &) = delete;
+    void recordAllocation()
+    {
+        liveCount.fetch_add(1, memory_order_relaxed);
+        allocationCount.fetch_add(1, memory_order_relaxed);
+    }
+    void recordDeallocation()
+    {
+        liveCount.fetch_sub(1, memory_order_relaxed);
+    }
+    static void dump(wostream & os);
+};
+
+template <typename Tag>
+PoolStatistics & getPoolStatistics()
+{
+    static PoolStatistics statistics(typeid(Tag).name());
+    return statistics;
+}
+
+template <typename T, typename Tag = T>
+class PoolAllocator final
+{
+public:
+    typedef T value_type;
+    template <typename U>
+    struct rebind
+    {
+        typedef PoolAllocator<U, Tag> other;
+    };
+    PoolAllocator() noexcept
+    {
+    }
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U, Tag> &) noexcept
+    {
+    }
+    T * allocate(size_t count)
+    {
+        static_assert(alignof(T) <= Pool::Granularity, "type is over-aligned for the pool");
+        T * retval = static_cast<T *>(Pool::allocate(count * sizeof(T)));
+        getPoolStatistics<Tag>().recordAllocation();
+        return retval;
+    }
+    void deallocate(T * block, size_t count)
+    {
+        getPoolStatistics<Tag>().recordDeallocation();
+        Pool::deallocate(block, count * sizeof(T));
+    }
+    friend bool operator ==(const PoolAllocator &, const PoolAllocator &)
+    {
+        return true;
+    }
+    friend bool operator !=(const PoolAllocator &, const PoolAllocator &)
+    {
+        return false;
+    }
+};
+
+#endif // POOLALLOCATOR_H_INCLUDED
@@ -0,0 +1,183 @@
+#include "programgenerator.h"
+
+using namespace std;
+
+namespace
+{
+const char * const words[] =
+{
+    "alpha", "beta", "gamma", "delta", "record", "value", "index", "count", "total", "result",
+    "buffer", "report", "config", "option", "handler", "module", "service", "request", "response", "cache",
+};
+
+const char * const soupPieces[] =
+{
+    "Dim", "As", "Integer", "Double", "String", "Boolean", "Pointer To", "New", "Delete", "Return",
+    "If", "Then", "ElseIf", "Else", "End If", "For", "To", "Step", "Next", "While", "Do", "Loop",
+    "AndAlso", "OrElse", "And", "Or", "Xor", "Not", "Mod", "CInt", "CDbl", "CStr", "True", "False", "Nothing",
+    "+", "-", "*", "/", "\\", "^", "=", "+=", "-=", "&", "&=", "<", ">", "<=", ">=", "<>", "<<", ">>",
+    "(", ")", "{", "}", ",", ":", ";", ":=", "#", ".",
+};
+}
+
+uint32_t ProgramGenerator::random(uint32_t limit)
+{
+    // xorshift32 : deterministic across platforms and standard libraries
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return limit == 0 ? 0 : randomState % limit;
+}
+
+void ProgramGenerator::write(const string & text)
+{
+    *os << text;
+    size += text.size();
+}
+
+void ProgramGenerator::writeLine(const string & text)
+{
+    write(string(indentLevel * 4, ' ') + text + "\n");
+}
+
+string ProgramGenerator::makeLiteral()
+{
+    switch(random(5))
+    {
+    case 0:
+        return to_string(random(100000));
+    case 1:
+        return to_string(random(1000)) + "." + to_string(random(1000)) + "e-" + to_string(random(10));
+    case 2:
+        return "&H" + to_string(random(10000)) + "F";
+    case 3:
+        return "&" + to_string(random(777));
+    default:
+        return string("\"") + words[random(sizeof(words) / sizeof(words[0]))] + " \"\"quoted\"\" " + words[random(sizeof(words) / sizeof(words[0]))] + "\"";
+    }
+}
+
+void ProgramGenerator::writeComment()
+{
+    string text = "'";
+    size_t wordCount = 4 + random(12);
+    for(size_t i = 0; i < wordCount; i++)
+    {
+        text += " ";
+        if(chance(25))
+            text += makeLiteral();
+        else
+            text += words[random(sizeof(words) / sizeof(words[0]))];
+    }
+    writeLine(text);
+}
+
+string ProgramGenerator::makeNamePath()
+{
+    string retval = "Global";
+    for(const string & name : namespacePath)
+        retval += "." + name;
+    return retval + ".I" + words[random(sizeof(words) / sizeof(words[0]))] + to_string(random(100));
+}
+
+void ProgramGenerator::generateClass()
+{
+    if(chance(options.commentPercent))
+        writeComment();
+    string line = "Class C" + to_string(classCount);
+    if(classCount > 0 && chance(70))
+        line += " Inherits C" + to_string(classCount - 1);
+    else
+        line += " Inherits Object";
+    if(options.interfacesPerClass > 0)
+    {
+        if(chance(options.continuationPercent))
+            line += " _ ' continued\n" + string((indentLevel + 2) * 4, ' ');
+        else
+            line += " ";
+        line += "Implements ";
+        for(size_t i = 0; i < options.interfacesPerClass; i++)
+        {
+            if(i > 0)
+                line += ", ";
+            line += makeNamePath();
+        }
+    }
+    classCount++;
+    writeLine(line);
+    indentLevel++;
+    if(chance(options.commentPercent))
+        writeComment();
+    indentLevel--;
+    writeLine("End Class");
+}
+
+void ProgramGenerator::generateNamespace(size_t depth)
+{
+    string name = "Level" + to_string(depth) + "_" + words[random(sizeof(words) / sizeof(words[0]))] + to_string(random(1000));
+    writeLine("Namespace " + name);
+    namespacePath.push_back(name);
+    indentLevel++;
+    for(size_t i = 0; i < options.classesPerNamespace && size < options.targetSize; i++)
+        generateClass();
+    if(size < options.targetSize)
+    {
+        writeLine("Block");
+        indentLevel++;
+        writeComment();
+        indentLevel--;
+        writeLine("End Block");
+    }
+    for(size_t i = 0; i < 2 && depth + 1 < options.namespaceDepth && size < options.targetSize; i++)
+        generateNamespace(depth + 1);
+    indentLevel--;
+    namespacePath.pop_back();
+    writeLine("End Namespace");
+}
+
+void ProgramGenerator::generateTokenSoupLine()
+{
+    string line;
+    size_t pieceCount = 6 + random(20);
+    for(size_t i = 0; i < pieceCount; i++)
+    {
+        if(i > 0)
+            line += " ";
+        switch(random(4))
+        {
+        case 0:
+            line += makeLiteral();
+            break;
+        case 1:
+            line += words[random(sizeof(words) / sizeof(words[0]))] + to_string(random(100));
+            break;
+        default:
+            line += soupPieces[random(sizeof(soupPieces) / sizeof(soupPieces[0]))];
+            break;
+        }
+        if(i + 1 < pieceCount && chance(options.continuationPercent / 4))
+            line += " _\n   ";
+    }
+    if(chance(options.commentPercent))
+        line += " ' trailing comment";
+    writeLine(line);
+}
+
+size_t ProgramGenerator::generate(ostream & os)
+{
+    this->os = &os;
+    size = 0;
+    indentLevel = 0;
+    classCount = 0;
+    randomState = options.seed != 0 ? options.seed : 1;
+    writeLine("' generated benchmark program");
+    while(size < options.targetSize)
+    {
+        if(options.kind == Kind::TokenSoup)
+            generateTokenSoupLine();
+        else
+            generateNamespace(0);
+    }
+    this->os = nullptr;
+    return size;
+}
@@ -0,0 +1,62 @@
+#ifndef PROGRAMGENERATOR_H_INCLUDED
+#define PROGRAMGENERATOR_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/** writes deterministic synthetic programs of a requested size for benchmarking */
+class ProgramGenerator final
+{
+public:
+    enum class Kind
+    {
+        Program,   // parseable : nested namespaces, class chains, blocks, comments and continuations
+        TokenSoup, // tokenizer only : literals, operators and keywords the parser doesn't accept yet
+    };
+    struct Options
+    {
+        Kind kind = Kind::Program;
+        size_t targetSize = 64 * 1024;
+        size_t namespaceDepth = 6;
+        size_t classesPerNamespace = 50;
+        size_t interfacesPerClass = 2;
+        size_t commentPercent = 30;
+        size_t continuationPercent = 20;
+        uint32_t seed = 1;
+    };
+private:
+    Options options;
+    ostream * os;
+    size_t size;
+    size_t indentLevel;
+    uint32_t randomState;
+    size_t classCount;
+    vector<string> namespacePath;
+    uint32_t random(uint32_t limit);
+    bool chance(size_t percent)
+    {
+        return random(100) < percent;
+    }
+    void write(const string & text);
+    void writeLine(const string & text);
+    void writeComment();
+    string makeLiteral();
+    string makeNamePath();
+    void generateClass();
+    void generateNamespace(size_t depth);
+    void generateTokenSoupLine();
+public:
+    explicit ProgramGenerator(Options options)
+        : options(options), os(nullptr), size(0), indentLevel(0), randomState(options.seed), classCount(0)
+    {
+    }
+    /** returns the number of bytes written */
+    size_t generate(ostream & os);
+};
+
+#endif // PROGRAMGENERATOR_H_INCLUDED
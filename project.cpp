@@ -0,0 +1,245 @@
+#include "project.h"
+#include <fstream>
+#include <iterator>
+#include <unordered_set>
+#include "parser.h"
+#include "astvisitor.h"
+#include "json.h"
+
+using namespace std;
+
+namespace
+{
+class PathFinder final : public ASTVisitor<PathFinder>
+{
+    Location location;
+public:
+    const ASTPeriod * found = nullptr;
+    explicit PathFinder(Location location)
+        : location(location)
+    {
+    }
+    ASTVisitResult prePeriod(const ASTPeriod & node)
+    {
+        if(!node.getLocation().contains(location))
+            return ASTVisitResult::SkipChildren;
+        found = &node;
+        return ASTVisitResult::Stop;
+    }
+};
+
+vector<size_t> findLineStarts(const wstring & text)
+{
+    vector<size_t> retval{0};
+    for(size_t i = 0; i < text.size(); i++)
+    {
+        if(text[i] == L'\r' && i + 1 < text.size() && text[i + 1] == L'\n')
+            i++;
+        if(text[i] == L'\r' || text[i] == L'\n')
+            retval.push_back(i + 1);
+    }
+    return retval;
+}
+}
+
+wstring Project::readFile(const string & path)
+{
+    ifstream is(path, ios::binary);
+    if(!is)
+        throw Exception(L"can't open " + JSONValue::fromUTF8(path));
+    return JSONValue::fromUTF8(string(istreambuf_iterator<char>(is), istreambuf_iterator<char>()));
+}
+
+bool Project::updateFile(const string & fileName, wstring text)
+{
+    auto iter = files.find(fileName);
+    if(iter != files.end() && get<1>(*iter).text == text)
+        return false;
+    SourceFile & file = files[fileName];
+    file.text = std::move(text);
+    file.lineStarts = findLineStarts(file.text);
+    file.diagnostics.clear();
+    file.declarations = nullptr;
+    statistics.parseCount++;
+    try
+    {
+        Parser parser(make_shared<StringParserInput>(file.text));
+        file.ast = parser.parse();
+    }
+    catch(ParseError & e)
+    {
+        file.ast = nullptr;
+        file.diagnostics.push_back(Diagnostic{fileName, e.location, e.message});
+    }
+    indexChanged = true;
+    return true;
+}
+
+bool Project::removeFile(const string & fileName)
+{
+    if(files.erase(fileName) == 0)
+        return false;
+    indexChanged = true;
+    return true;
+}
+
+vector<string> Project::getFileNames() const
+{
+    vector<string> retval;
+    retval.reserve(files.size());
+    for(const pair<const string, SourceFile> & file : files)
+        retval.push_back(get<0>(file));
+    return retval;
+}
+
+void Project::updateIndex()
+{
+    if(!indexChanged)
+        return;
+    indexChanged = false;
+    statistics.indexBuildCount++;
+    hierarchy = nullptr;
+    hierarchyDiagnostics.clear();
+    rootFileNames.clear();
+    vector<shared_ptr<const ClassHierarchy::Declarations>> declarations;
+    for(pair<const string, SourceFile> & file : files)
+    {
+        SourceFile & sourceFile = get<1>(file);
+        if(sourceFile.ast == nullptr)
+            continue;
+        if(sourceFile.declarations == nullptr)
+        {
+            sourceFile.declarations = ClassHierarchy::collect(*sourceFile.ast);
+            statistics.collectCount++;
+        }
+        declarations.push_back(sourceFile.declarations);
+        rootFileNames.push_back(&get<0>(file));
+    }
+    hierarchy.reset(new ClassHierarchy(declarations));
+    for(const ClassHierarchy::Error & e : hierarchy->getErrors())
+        hierarchyDiagnostics.push_back(Diagnostic{*rootFileNames[e.root], e.location, e.message});
+}
+
+const ClassHierarchy * Project::getClassHierarchy()
+{
+    updateIndex();
+    return hierarchy.get();
+}
+
+vector<Project::Diagnostic> Project::getDiagnostics(const string & fileName)
+{
+    updateIndex();
+    vector<Diagnostic> retval;
+    const SourceFile * file = findFile(fileName);
+    if(file != nullptr)
+        retval = file->diagnostics;
+    for(const Diagnostic & diagnostic : hierarchyDiagnostics)
+    {
+        if(diagnostic.fileName == fileName)
+            retval.push_back(diagnostic);
+    }
+    return retval;
+}
+
+const Project::SourceFile * Project::findFile(const string & fileName) const
+{
+    auto iter = files.find(fileName);
+    if(iter == files.end())
+        return nullptr;
+    return &get<1>(*iter);
+}
+
+const ASTPeriod * Project::findPath(const string & fileName, Location location) const
+{
+    const SourceFile * file = findFile(fileName);
+    if(file == nullptr || file->ast == nullptr)
+        return nullptr;
+    PathFinder finder(location);
+    finder.walk(*file->ast);
+    return finder.found;
+}
+
+Project::Definition Project::makeDefinition(const ClassHierarchy::ClassInfo & classInfo) const
+{
+    return Definition{*rootFileNames[classInfo.root], classInfo.getName()->getLocation(), classInfo.fullName};
+}
+
+bool Project::findDefinition(const string & fileName, Location location, Definition & definition)
+{
+    updateIndex();
+    const ASTPeriod * path = findPath(fileName, location);
+    if(path == nullptr)
+        return false;
+    const ClassHierarchy::ClassInfo * classInfo = hierarchy->find(hierarchy->getReferenceName(path));
+    if(classInfo == nullptr)
+        return false;
+    definition = makeDefinition(*classInfo);
+    return true;
+}
+
+vector<Project::Definition> Project::findImplementations(const string & fileName, Location location)
+{
+    updateIndex();
+    vector<Definition> retval;
+    const ASTPeriod * path = findPath(fileName, location);
+    if(path == nullptr)
+        return retval;
+    const wstring & name = hierarchy->getReferenceName(path);
+    if(name.empty())
+        return retval;
+    if(const ClassHierarchy::ClassInfo * classInfo = hierarchy->find(name))
+    {
+        // ClassHierarchy rejects inheritance cycles; the visited set keeps a cycle it misses from hanging the server
+        unordered_set<const ClassHierarchy::ClassInfo *> visited{classInfo};
+        vector<const ClassHierarchy::ClassInfo *> pending(classInfo->derived.begin(), classInfo->derived.end());
+        while(!pending.empty())
+        {
+            const ClassHierarchy::ClassInfo * derived = pending.back();
+            pending.pop_back();
+            if(!visited.insert(derived).second)
+                continue;
+            retval.push_back(makeDefinition(*derived));
+            pending.insert(pending.end(), derived->derived.begin(), derived->derived.end());
+        }
+    }
+    else
+    {
+        for(const ClassHierarchy::ClassInfo * implementer : hierarchy->getImplementers(name))
+            retval.push_back(makeDefinition(*implementer));
+    }
+    return retval;
+}
+
+bool Project::toLocation(const string & fileName, size_t line, size_t character, Location & location) const
+{
+    const SourceFile * file = findFile(fileName);
+    if(file == nullptr || line >= file->lineStarts.size())
+        return false;
+    Location::LocationState state = Location::LocationState::Start;
+    location = Location(line + 1, 1);
+    for(size_t i = file->lineStarts[line]; i < file->text.size() && i < file->lineStarts[line] + character; i++)
+    {
+        if(file->text[i] == L'\r' || file->text[i] == L'\n')
+            break;
+        location = location.getNext(file->text[i], state);
+    }
+    return true;
+}
+
+bool Project::toPosition(const string & fileName, Location location, size_t & line, size_t & character) const
+{
+    const SourceFile * file = findFile(fileName);
+    if(file == nullptr || location.line == 0 || location.line > file->lineStarts.size())
+        return false;
+    line = location.line - 1;
+    character = 0;
+    Location::LocationState state = Location::LocationState::Start;
+    Location current(location.line, 1);
+    for(size_t i = file->lineStarts[line]; i < file->text.size() && current.column < location.column; i++, character++)
+    {
+        if(file->text[i] == L'\r' || file->text[i] == L'\n')
+            break;
+        current = current.getNext(file->text[i], state);
+    }
+    return true;
+}
@@ -0,0 +1,90 @@
+#ifndef PROJECT_H_INCLUDED
+#define PROJECT_H_INCLUDED
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "location.h"
+#include "astnode.h"
+#include "astperiod.h"
+#include "classhierarchy.h"
+
+using namespace std;
+
+/** the source files of one program, each parsed on its own, plus a class hierarchy over all of them
+ *
+ * updating a file reparses only that file; the class hierarchy is relinked lazily, only after a file's tree actually changed,
+ * from each file's cached class declarations, so only the changed files are walked again
+ */
+class Project final
+{
+public:
+    struct Diagnostic final
+    {
+        string fileName;
+        LocationRange location;
+        wstring message;
+    };
+    struct Definition final
+    {
+        string fileName;
+        LocationRange location;
+        wstring fullName;
+    };
+    struct Statistics final
+    {
+        size_t parseCount = 0;
+        size_t collectCount = 0; // files whose classes were collected for the hierarchy
+        size_t indexBuildCount = 0;
+    };
+private:
+    struct SourceFile final
+    {
+        wstring text;
+        vector<size_t> lineStarts;
+        shared_ptr<ASTNode> ast; // nullptr when the file doesn't parse
+        shared_ptr<const ClassHierarchy::Declarations> declarations; // nullptr until the index is next updated
+        vector<Diagnostic> diagnostics;
+    };
+    map<string, SourceFile> files;
+    vector<const string *> rootFileNames; // the file declaring each global block given to the class hierarchy
+    unique_ptr<ClassHierarchy> hierarchy;
+    vector<Diagnostic> hierarchyDiagnostics;
+    bool indexChanged = true;
+    Statistics statistics;
+    void updateIndex();
+    const SourceFile * findFile(const string & fileName) const;
+    const ASTPeriod * findPath(const string & fileName, Location location) const;
+    Definition makeDefinition(const ClassHierarchy::ClassInfo & classInfo) const;
+public:
+    /** reads a file as UTF-8; throws Exception if it can't be read */
+    static wstring readFile(const string & path);
+    /** returns false if the text is unchanged, in which case nothing is reparsed */
+    bool updateFile(const string & fileName, wstring text);
+    /** returns false if there was no such file */
+    bool removeFile(const string & fileName);
+    bool hasFile(const string & fileName) const
+    {
+        return files.count(fileName) != 0;
+    }
+    vector<string> getFileNames() const;
+    /** whole-program errors are left out of the hierarchy and reported by getDiagnostics */
+    const ClassHierarchy * getClassHierarchy();
+    /** parse errors for the file plus whole-program errors located in it */
+    vector<Diagnostic> getDiagnostics(const string & fileName);
+    /** finds the class that the class name, Inherits or Implements path at location refers to */
+    bool findDefinition(const string & fileName, Location location, Definition & definition);
+    /** for a class, every class deriving from it; for an interface, every class implementing it */
+    vector<Definition> findImplementations(const string & fileName, Location location);
+    /** converts between Locations and zero based (line, character) positions */
+    bool toLocation(const string & fileName, size_t line, size_t character, Location & location) const;
+    bool toPosition(const string & fileName, Location location, size_t & line, size_t & character) const;
+    const Statistics & getStatistics() const
+    {
+        return statistics;
+    }
+};
+
+#endif // PROJECT_H_INCLUDED
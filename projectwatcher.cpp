@@ -0,0 +1,159 @@
+#include "projectwatcher.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include "parser.h"
+#include "json.h"
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+pair<string, string> splitPath(const string & fileName)
+{
+    size_t slash = fileName.find_last_of('/');
+    if(slash == string::npos)
+        return make_pair(string("."), fileName);
+    return make_pair(slash == 0 ? string("/") : fileName.substr(0, slash), fileName.substr(slash + 1));
+}
+}
+
+ProjectWatcher::ProjectWatcher(const vector<string> & fileNames, wostream & os, size_t debounceMilliseconds)
+    : os(os), debounceMilliseconds(debounceMilliseconds)
+{
+    for(const string & fileName : fileNames)
+        watchedFiles[splitPath(fileName)] = fileName;
+}
+
+void ProjectWatcher::load(const string & fileName)
+{
+    try
+    {
+        project.updateFile(fileName, Project::readFile(fileName));
+    }
+    catch(Exception &)
+    {
+        project.removeFile(fileName); // deleted or renamed away; it comes back with the next write
+    }
+}
+
+void ProjectWatcher::report(const set<string> & changed, double milliseconds)
+{
+    Project::Statistics statistics = project.getStatistics();
+    os << L"[watch] " << changed.size() << L" file(s) changed, " << statistics.parseCount - reportedStatistics.parseCount << L" reparsed, ";
+    os << statistics.collectCount - reportedStatistics.collectCount << L" re-collected, ";
+    os << (statistics.indexBuildCount != reportedStatistics.indexBuildCount ? L"hierarchy relinked, " : L"hierarchy unchanged, ");
+    os << fixed << setprecision(3) << milliseconds << L" ms\n";
+    reportedStatistics = statistics;
+    for(const pair<const pair<string, string>, string> & watchedFile : watchedFiles)
+    {
+        const string & fileName = get<1>(watchedFile);
+        vector<wstring> diagnostics;
+        if(!project.hasFile(fileName))
+            diagnostics.push_back(L"can't read file");
+        for(const Project::Diagnostic & diagnostic : project.getDiagnostics(fileName))
+            diagnostics.push_back(diagnostic.location.toString() + L" : " + diagnostic.message);
+        auto iter = reportedDiagnostics.find(fileName);
+        if(iter != reportedDiagnostics.end() && get<1>(*iter) == diagnostics)
+            continue;
+        os << JSONValue::fromUTF8(fileName) << L" : " << (diagnostics.empty() ? L"no errors" : L"") << L"\n";
+        for(const wstring & diagnostic : diagnostics)
+            os << L"    " << diagnostic << L"\n";
+        reportedDiagnostics[fileName] = std::move(diagnostics);
+    }
+    os.flush();
+}
+
+int ProjectWatcher::run()
+{
+#ifdef __linux__
+    int fd = inotify_init1(IN_CLOEXEC);
+    if(fd < 0)
+    {
+        os << L"Error : can't initialize inotify : " << strerror(errno) << endl;
+        return 1;
+    }
+    map<int, string> directories;
+    set<string> addedDirectories;
+    for(const pair<const pair<string, string>, string> & watchedFile : watchedFiles)
+    {
+        const string & directory = get<0>(get<0>(watchedFile));
+        if(!addedDirectories.insert(directory).second)
+            continue;
+        // editors often save by writing a new file and renaming it over the old one, so watch the directory
+        int wd = inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE);
+        if(wd < 0)
+        {
+            os << L"Error : can't watch " << JSONValue::fromUTF8(directory) << L" : " << strerror(errno) << endl;
+            close(fd);
+            return 1;
+        }
+        directories[wd] = directory;
+    }
+    set<string> changed;
+    chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+    for(const pair<const pair<string, string>, string> & watchedFile : watchedFiles)
+    {
+        changed.insert(get<1>(watchedFile));
+        load(get<1>(watchedFile));
+    }
+    project.getClassHierarchy();
+    report(changed, chrono::duration<double, milli>(chrono::steady_clock::now() - startTime).count());
+    alignas(inotify_event) char buffer[16 * 1024];
+    for(;;)
+    {
+        changed.clear();
+        pollfd pfd = {fd, POLLIN, 0};
+        int timeout = -1; // block until the first event, then until the burst is over
+        for(;;)
+        {
+            int result = poll(&pfd, 1, timeout);
+            if(result < 0 && errno == EINTR)
+                continue;
+            if(result < 0)
+            {
+                os << L"Error : poll failed : " << strerror(errno) << endl;
+                close(fd);
+                return 1;
+            }
+            if(result == 0)
+                break;
+            ssize_t length = read(fd, buffer, sizeof(buffer));
+            if(length < 0 && errno != EINTR && errno != EAGAIN)
+            {
+                os << L"Error : can't read inotify events : " << strerror(errno) << endl;
+                close(fd);
+                return 1;
+            }
+            for(ssize_t offset = 0; offset < length;)
+            {
+                const inotify_event * event = reinterpret_cast<const inotify_event *>(buffer + offset);
+                offset += sizeof(inotify_event) + event->len;
+                auto directory = directories.find(event->wd);
+                if(event->len == 0 || directory == directories.end())
+                    continue;
+                auto watchedFile = watchedFiles.find(make_pair(get<1>(*directory), string(event->name)));
+                if(watchedFile != watchedFiles.end())
+                    changed.insert(get<1>(*watchedFile));
+            }
+            timeout = (int)debounceMilliseconds;
+        }
+        if(changed.empty())
+            continue;
+        startTime = chrono::steady_clock::now();
+        for(const string & fileName : changed)
+            load(fileName);
+        project.getClassHierarchy();
+        report(changed, chrono::duration<double, milli>(chrono::steady_clock::now() - startTime).count());
+    }
+#else
+    os << L"Error : --watch needs Linux inotify" << endl;
+    return 1;
+#endif
+}
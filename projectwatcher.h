@@ -0,0 +1,37 @@
+#ifndef PROJECTWATCHER_H_INCLUDED
+#define PROJECTWATCHER_H_INCLUDED
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include <ostream>
+#include "project.h"
+
+using namespace std;
+
+/** --watch : keeps a Project of the given files up to date from inotify events and reports diagnostics as they change
+ *
+ * bursts of events are debounced into one update; only files whose text changed are reparsed,
+ * only their classes are collected again before the class hierarchy is relinked, and only files whose diagnostics changed are reported
+ */
+class ProjectWatcher final
+{
+    Project project;
+    wostream & os;
+    size_t debounceMilliseconds;
+    map<pair<string, string>, string> watchedFiles; // (directory, name) to the name given on the command line
+    map<string, vector<wstring>> reportedDiagnostics;
+    Project::Statistics reportedStatistics;
+    void load(const string & fileName);
+    void report(const set<string> & changed, double milliseconds);
+public:
+    static constexpr size_t DefaultDebounceMilliseconds = 50;
+    ProjectWatcher(const vector<string> & fileNames, wostream & os, size_t debounceMilliseconds = DefaultDebounceMilliseconds);
+    /** watches until killed; returns the process exit code if watching fails */
+    int run();
+};
+
+#endif // PROJECTWATCHER_H_INCLUDED
@@ -189,7 +189,7 @@ struct Token final
     wstring value;
     LocationRange location;
     Token(TokenType type, wstring value, LocationRange location = LocationRange(Location(0, 0)))
-        : type(type), value(value), location(location)
+        : type(type), value(std::move(value)), location(location)
     {
     }
     Token(TokenType type)
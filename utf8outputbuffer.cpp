@@ -0,0 +1,104 @@
+#include "utf8outputbuffer.h"
+#include <cerrno>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+constexpr size_t MaxEncodedSize = 4;
+
+long writeBytes(int fd, const char * bytes, size_t count)
+{
+#ifdef _WIN32
+    return _write(fd, bytes, (unsigned)count);
+#else
+    return (long)::write(fd, bytes, count);
+#endif
+}
+}
+
+UTF8OutputBuffer::UTF8OutputBuffer(int fd, size_t bufferSize)
+    : fd(fd), buffer(bufferSize < MaxEncodedSize ? MaxEncodedSize : bufferSize)
+{
+}
+
+UTF8OutputBuffer::~UTF8OutputBuffer()
+{
+    flushBuffer();
+}
+
+bool UTF8OutputBuffer::flushBuffer()
+{
+    size_t start = 0;
+    while(start < used && !failed)
+    {
+        long result = writeBytes(fd, &buffer[start], used - start);
+        if(result < 0 && errno == EINTR)
+            continue;
+        if(result <= 0)
+            failed = true;
+        else
+            start += (size_t)result;
+    }
+    bytesWritten += used;
+    used = 0;
+    return !failed;
+}
+
+void UTF8OutputBuffer::putMultiByte(unsigned codePoint)
+{
+    if(codePoint < 0x800)
+    {
+        buffer[used++] = (char)(0xC0 | (codePoint >> 6));
+        buffer[used++] = (char)(0x80 | (codePoint & 0x3F));
+    }
+    else if(codePoint < 0x10000)
+    {
+        buffer[used++] = (char)(0xE0 | (codePoint >> 12));
+        buffer[used++] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        buffer[used++] = (char)(0x80 | (codePoint & 0x3F));
+    }
+    else
+    {
+        buffer[used++] = (char)(0xF0 | (codePoint >> 18));
+        buffer[used++] = (char)(0x80 | ((codePoint >> 12) & 0x3F));
+        buffer[used++] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        buffer[used++] = (char)(0x80 | (codePoint & 0x3F));
+    }
+}
+
+UTF8OutputBuffer::int_type UTF8OutputBuffer::overflow(int_type ch)
+{
+    if(traits_type::eq_int_type(ch, traits_type::eof()))
+        return sync() == 0 ? traits_type::not_eof(ch) : traits_type::eof();
+    if(buffer.size() - used < MaxEncodedSize && !flushBuffer())
+        return traits_type::eof();
+    put(traits_type::to_char_type(ch));
+    return ch;
+}
+
+streamsize UTF8OutputBuffer::xsputn(const char_type * s, streamsize n)
+{
+    for(streamsize i = 0; i < n;)
+    {
+        if(buffer.size() - used < MaxEncodedSize && !flushBuffer())
+            return i;
+        // every character takes at most MaxEncodedSize bytes, so this many always fit without checking
+        streamsize count = (streamsize)((buffer.size() - used) / MaxEncodedSize);
+        if(count > n - i)
+            count = n - i;
+        for(streamsize end = i + count; i < end; i++)
+            put(s[i]);
+    }
+    return n;
+}
+
+int UTF8OutputBuffer::sync()
+{
+    return flushBuffer() ? 0 : -1;
+}
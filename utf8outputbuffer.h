@@ -0,0 +1,48 @@
+#ifndef UTF8OUTPUTBUFFER_H_INCLUDED
+#define UTF8OUTPUTBUFFER_H_INCLUDED
+
+#include <cstddef>
+#include <streambuf>
+#include <vector>
+
+using namespace std;
+
+/** wide stream buffer that encodes to UTF-8 in a large byte buffer and writes it to a file descriptor in big chunks
+ *
+ * bypasses the locale's codecvt and the per-character stream machinery; flushes only when full, on sync and on destruction
+ */
+class UTF8OutputBuffer final : public wstreambuf
+{
+    int fd;
+    vector<char> buffer;
+    size_t used = 0;
+    size_t bytesWritten = 0;
+    bool failed = false;
+    bool flushBuffer();
+    void put(wchar_t ch)
+    {
+        unsigned codePoint = (unsigned)ch;
+        if(codePoint < 0x80)
+            buffer[used++] = (char)codePoint;
+        else
+            putMultiByte(codePoint);
+    }
+    void putMultiByte(unsigned codePoint);
+public:
+    static constexpr size_t DefaultBufferSize = 1 << 16;
+    explicit UTF8OutputBuffer(int fd, size_t bufferSize = DefaultBufferSize);
+    UTF8OutputBuffer(const UTF8OutputBuffer &) = delete;
+    const UTF8OutputBuffer & operator =(const UTF8OutputBuffer &) = delete;
+    virtual ~UTF8OutputBuffer();
+    /** the number of bytes encoded so far, including bytes not yet written */
+    size_t getByteCount() const
+    {
+        return bytesWritten + used;
+    }
+protected:
+    virtual int_type overflow(int_type ch) override;
+    virtual streamsize xsputn(const char_type * s, streamsize n) override;
+    virtual int sync() override;
+};
+
+#endif // UTF8OUTPUTBUFFER_H_INCLUDED